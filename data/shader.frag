@@ -5,6 +5,7 @@ in VS_OUT {
 	vec3 FragPos;
 	vec3 Normal;
 	vec2 TexCoords;
+	vec3 Albedo;
 } fs_in;
 
 uniform vec3 viewPos;
@@ -12,10 +13,11 @@ uniform vec3 lightDir;
 uniform vec3 lightColor;
 uniform vec3 lightAmbient;
 
-uniform vec3 albedo;
-
 void main()
 {
+	// the vertex shader passes the color of the object or of the instance
+	vec3 albedo = fs_in.Albedo;
+
 	// ambient
 	vec3 ambient = lightAmbient * albedo;
 	
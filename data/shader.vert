@@ -8,11 +8,13 @@ out VS_OUT {
 	vec3 FragPos;
 	vec3 Normal;
 	vec2 TexCoords;
+	vec3 Albedo;
 } vs_out;
 
 uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
+uniform vec3 albedo;
 
 void main()
 {
@@ -20,6 +22,7 @@ void main()
 	vs_out.FragPos = vec3(model * vec4(aPos, 1.0));
 	vs_out.Normal = mat3(model) * aNormal;
 	vs_out.TexCoords = aTexCoords;
+	vs_out.Albedo = albedo;
 
 	gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
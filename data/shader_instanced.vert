@@ -0,0 +1,29 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+// per-instance attributes, a matrix takes four locations
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in vec3 aColor;
+
+// declare an interface block
+out VS_OUT {
+	vec3 FragPos;
+	vec3 Normal;
+	vec2 TexCoords;
+	vec3 Albedo;
+} vs_out;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+void main()
+{
+	// convert local to world position and normals
+	vs_out.FragPos = vec3(aModel * vec4(aPos, 1.0));
+	vs_out.Normal = mat3(aModel) * aNormal;
+	vs_out.TexCoords = aTexCoords;
+	vs_out.Albedo = aColor;
+
+	gl_Position = projection * view * aModel * vec4(aPos, 1.0);
+}
\ No newline at end of file
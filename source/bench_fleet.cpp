@@ -0,0 +1,118 @@
+// Benchmark of the fleet update cost per car, serial and split across the job system.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O3 -fno-math-errno -pthread -Iinclude -Isource source/bench_fleet.cpp -o bench_fleet
+// Usage: bench_fleet [cars] [ticks]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "solution/train_fleet.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Global settings
+//-----------------------------------------------------------------------------
+
+#define SETTINGS_TRAIN_SPEED        1.2f
+#define SETTINGS_TRAIN_ACCELERATION 0.4f
+#define SETTINGS_TRAIN_BRAKING      0.8f
+#define SETTINGS_CARS_COUNT         4
+#define SETTINGS_CARS_COUPLING      1.4f
+#define SETTINGS_FIXED_TIMESTEP     (1.0f / 60.0f)
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+int main(int argc, char ** argv) {
+	const size_t cars = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+	const size_t ticks = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000;
+
+	// half of the cars run on a loop, the other half on an open track they stop at the end of
+	std::vector<vec3> controlPoints;
+	for (int i = 0; i < 8; i++) {
+		const float angle = 6.2831853f * static_cast<float>(i) / 8.0f;
+		controlPoints.emplace_back(10.0f * std::cos(angle), 0.0f, 10.0f * std::sin(angle));
+	}
+	const Spline loop(controlPoints, 0.01f, true);
+	const Spline open(controlPoints, 0.01f, false);
+	const SplineFrames loopFrames(loop);
+	const SplineFrames openFrames(open);
+
+	const auto populate = [&](TrainFleet & fleet) {
+		const uint32_t loopTrack = fleet.addTrack(loopFrames);
+		const uint32_t openTrack = fleet.addTrack(openFrames);
+		fleet.reserve(cars);
+		for (size_t i = 0; i < cars; i++) {
+			const size_t car = i % SETTINGS_CARS_COUNT;
+			fleet.addCar(i % 2 ? loopTrack : openTrack, static_cast<float>(i % 50), SETTINGS_TRAIN_SPEED,
+			             SETTINGS_CARS_COUPLING * static_cast<float>(car));
+		}
+	};
+
+	//-----------------------------------------------------------------------------
+	// Serial update and transforms
+	//-----------------------------------------------------------------------------
+
+	TrainFleet serial(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+	populate(serial);
+	auto start = chrono::steady_clock::now();
+	for (size_t tick = 0; tick < ticks; tick++) {
+		serial.update(SETTINGS_FIXED_TIMESTEP);
+	}
+	const double update = getSeconds(start);
+
+	start = chrono::steady_clock::now();
+	const size_t transformTicks = ticks / 10 + 1;
+	for (size_t tick = 0; tick < transformTicks; tick++) {
+		serial.updateTransforms();
+	}
+	const double transforms = getSeconds(start);
+
+	const double carTicks = static_cast<double>(cars) * static_cast<double>(ticks);
+	printf("%zu cars, %zu ticks\n", cars, ticks);
+	printf("update:     %.2f ns per car and tick\n", update * 1e9 / carTicks);
+	printf("transforms: %.1f ns per car and tick\n",
+	       transforms * 1e9 / (static_cast<double>(cars) * static_cast<double>(transformTicks)));
+
+	//-----------------------------------------------------------------------------
+	// Update and transforms split across the job system, checked against the serial result
+	//-----------------------------------------------------------------------------
+
+	const size_t jobTicks = ticks / 10 + 1;
+	for (const size_t threads : { 1, 2, 4, 8 }) {
+		TrainFleet reference(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+		TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+		populate(reference);
+		populate(fleet);
+		JobSystem jobs(threads);
+
+		start = chrono::steady_clock::now();
+		for (size_t tick = 0; tick < jobTicks; tick++) {
+			fleet.update(SETTINGS_FIXED_TIMESTEP, jobs);
+		}
+		const double seconds = getSeconds(start);
+
+		for (size_t tick = 0; tick < jobTicks; tick++) {
+			reference.update(SETTINGS_FIXED_TIMESTEP);
+		}
+		reference.updateTransforms();
+		const bool isSame = fleet.getDistances() == reference.getDistances() &&
+		                    memcmp(fleet.getTransforms().data(), reference.getTransforms().data(),
+		                           cars * sizeof(mat4)) == 0;
+		printf("jobs, %zu threads: %.1f ns per car and tick, update and transforms, %s\n", threads,
+		       seconds * 1e9 / (static_cast<double>(cars) * static_cast<double>(jobTicks)),
+		       isSame ? "identical to serial" : "DIFFERS from serial");
+		if (!isSame) {
+			return 1;
+		}
+	}
+	return 0;
+}
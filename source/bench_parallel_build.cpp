@@ -0,0 +1,77 @@
+// Scaling benchmark of the parallel spline construction for 1, 2, 4 and 8 threads, every build is checked
+// to be identical to the serial one.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -pthread -Iinclude -Isource source/bench_parallel_build.cpp -o bench_parallel_build
+// Usage: bench_parallel_build [control points] [adaptive]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "solution/spline.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+static bool isIdentical(const Spline & a, const Spline & b) {
+	return a.getOffsets() == b.getOffsets() && a.getPoints().getX() == b.getPoints().getX() &&
+	       a.getPoints().getY() == b.getPoints().getY() && a.getPoints().getZ() == b.getPoints().getZ() &&
+	       a.getDistances() == b.getDistances();
+}
+
+int main(int argc, char ** argv) {
+	const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 50000;
+	const bool isAdaptive = argc > 2 && strcmp(argv[2], "adaptive") == 0;
+
+	// an imported network flattened into one long winding track
+	srand(1);
+	std::vector<vec3> controlPoints;
+	for (size_t i = 0; i < count; i++) {
+		controlPoints.emplace_back(static_cast<float>(i) * 10.0f, static_cast<float>(rand() % 10) * 0.1f,
+		                           static_cast<float>(rand() % 100) * 0.2f);
+	}
+	printf("%zu control points, %s tessellation, %u hardware threads\n", count, isAdaptive ? "adaptive" : "uniform",
+	       thread::hardware_concurrency());
+
+	const auto build = [&controlPoints, isAdaptive](const size_t threads) {
+		Spline spline;
+		if (isAdaptive) {
+			spline.constructAdaptive(controlPoints, 0.005f, false, threads);
+		} else {
+			spline.construct(controlPoints, 0.01f, false, threads);
+		}
+		return spline;
+	};
+
+	const Spline serial = build(1);
+	double baseline = 0.0;
+	for (const size_t threads : { 1, 2, 4, 8 }) {
+		// best of three, the first run also pays for the page faults of the buffers
+		double best = 1e30;
+		bool isSame = true;
+		for (int run = 0; run < 3; run++) {
+			const auto start = chrono::steady_clock::now();
+			const Spline spline = build(threads);
+			best = std::min(best, getSeconds(start));
+			isSame &= isIdentical(spline, serial);
+		}
+		if (threads == 1) {
+			baseline = best;
+		}
+		printf("%zu threads: %8.2f ms, speed-up %.2f, %zu points, %s\n", threads, best * 1000.0, baseline / best,
+		       serial.getPoints().size(), isSame ? "identical to serial" : "DIFFERS from serial");
+		if (!isSame) {
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,116 @@
+// Benchmark of Spline::resample against the stepping approximation it replaced, speed and spacing error.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/bench_resample.cpp -o bench_resample
+// Usage: bench_resample [control points] [ties]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+#include "solution/spline.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Former Spline::approx, steps of eps through Spline::get with the haul heuristic
+//-----------------------------------------------------------------------------
+
+static Spline approx(const Spline & spline, const size_t n, const float eps = .001f) {
+	Spline result(spline.isLoop());
+	float haul = .0f;
+	float minimum = numeric_limits<float>::max();
+	const float interval = spline.distance() / static_cast<float>(n);
+	float dt = eps;
+	do {
+		if (result.empty()) {
+			result.pushBack(spline.get(dt - eps));
+			continue;
+		}
+
+		const vec3 p1 = spline.get(dt - eps);
+		const vec3 p2 = spline.get(dt);
+		const vec3 v = (p2 - p1) * dt;
+		haul += length(v) / dt;
+		const float delta = fabs(haul - interval);
+
+		if (delta < minimum) {
+			minimum = delta;
+			dt += eps;
+		} else {
+			haul = .0f;
+			minimum = numeric_limits<float>::max();
+			result.pushBack(p2);
+		}
+	} while (dt <= 1.0f);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+static void report(const char * name, const Spline & spline, const double seconds) {
+	// every point, toVector leaves out the last one of an open spline
+	std::vector<vec3> points;
+	for (size_t k = 0; k < spline.getPoints().size(); k++) {
+		points.push_back(spline.getPoints().get(k));
+	}
+	if (points.size() < 2) {
+		printf("%-8s %10.3f ms, %zu points\n", name, seconds * 1000.0, points.size());
+		return;
+	}
+	double sum = 0.0;
+	for (size_t i = 0; i + 1 < points.size(); i++) {
+		sum += distance(points[i], points[i + 1]);
+	}
+	const double mean = sum / static_cast<double>(points.size() - 1);
+	double deviation = 0.0;
+	for (size_t i = 0; i + 1 < points.size(); i++) {
+		deviation = std::max(deviation, fabs(distance(points[i], points[i + 1]) - mean));
+	}
+	printf("%-8s %10.3f ms, %zu points, mean spacing %.4f, worst deviation %.5f (%.2f%%)\n", name, seconds * 1000.0,
+	       points.size(), mean, deviation, 100.0 * deviation / mean);
+}
+
+int main(int argc, char ** argv) {
+	const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 0;
+	const size_t ties = argc > 2 ? strtoul(argv[2], nullptr, 10) : 128;
+
+	// the demo loop by default, otherwise a random open track with points 10 units apart
+	std::vector<vec3> controlPoints = {
+		{ 0.0f, -0.375f, 7.0f },
+		{ -6.0f, -0.375f, 5.0f },
+		{ -8.0f, -0.375f, 1.0f },
+		{ -4.0f, -0.375f, -6.0f },
+		{ 0.0f, -0.375f, -7.0f },
+		{ 1.0f, -0.375f, -4.0f },
+		{ 4.0f, -0.375f, -3.0f },
+		{ 8.0f, -0.375f, 7.0f }
+	};
+	const bool isLoop = count == 0;
+	if (!isLoop) {
+		srand(1);
+		controlPoints.clear();
+		for (size_t i = 0; i < count; i++) {
+			controlPoints.emplace_back(static_cast<float>(i) * 10.0f, 0.0f, static_cast<float>(rand() % 100) * 0.2f);
+		}
+	}
+
+	const Spline spline(controlPoints, 0.01f, isLoop);
+	printf("track: %zu control points, %.2f units, %zu ties\n", controlPoints.size(), spline.distance(), ties);
+
+	auto start = chrono::steady_clock::now();
+	const Spline before = approx(spline, ties);
+	report("approx", before, getSeconds(start));
+
+	start = chrono::steady_clock::now();
+	const Spline after = Spline::resample(spline, ties);
+	report("resample", after, getSeconds(start));
+	return 0;
+}
@@ -0,0 +1,146 @@
+// Benchmark of the route planner on a synthetic grid network of about 100k directed edges: uncached queries
+// for plain A* and for landmark bounds, a check of the landmark routes against plain A*, a station dispatch
+// workload through the cache and the invalidation by a switch change, exits with 1 on an invalid route.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/bench_route_planner.cpp -o bench_route_planner
+// Usage: bench_route_planner [grid width]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+#include "solution/route_planner.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+// the route runs along connected edges from the from node to the to node
+static bool isValid(const TrackGraph & graph, const Route & route, const uint32_t from, const uint32_t to) {
+	if (from == to) {
+		return route.empty();
+	}
+	if (route.empty() || graph.getFrom(route.edges.front()) != from || graph.getTo(route.edges.back()) != to) {
+		return false;
+	}
+	for (size_t i = 0; i + 1 < route.edges.size(); i++) {
+		if (graph.getTo(route.edges[i]) != graph.getFrom(route.edges[i + 1])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	const auto width = static_cast<uint32_t>(argc > 1 ? strtoul(argv[1], nullptr, 10) : 160);
+
+	//-----------------------------------------------------------------------------
+	// Grid of nodes 10 units apart, neighbours linked both ways by slightly bent tracks
+	//-----------------------------------------------------------------------------
+
+	auto start = chrono::steady_clock::now();
+	TrackGraph graph;
+	for (uint32_t i = 0; i < width * width; i++) {
+		graph.addNode();
+	}
+	mt19937 random(1);
+	uniform_real_distribution<float> bend(-2.0f, 2.0f);
+	const auto link = [&graph, &random, &bend, width](const uint32_t a, const uint32_t b) {
+		const vec3 p(static_cast<float>(a % width) * 10.0f, 0.0f, static_cast<float>(a / width) * 10.0f);
+		const vec3 q(static_cast<float>(b % width) * 10.0f, 0.0f, static_cast<float>(b / width) * 10.0f);
+		const vec3 middle = mix(p, q, 0.5f) + vec3(bend(random), 0.0f, bend(random));
+		graph.addEdge(a, b, Spline(std::vector<vec3>{ p, middle, q }, 0.1f, false));
+		graph.addEdge(b, a, Spline(std::vector<vec3>{ q, middle, p }, 0.1f, false));
+	};
+	for (uint32_t y = 0; y < width; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			if (x + 1 < width) {
+				link(y * width + x, y * width + x + 1);
+			}
+			if (y + 1 < width) {
+				link(y * width + x, (y + 1) * width + x);
+			}
+		}
+	}
+	graph.build();
+	printf("network: %zu nodes, %zu edges, built in %.2f s\n", graph.getNodeCount(), graph.getEdgeCount(),
+	       getSeconds(start));
+
+	uniform_int_distribution<uint32_t> node(0, width * width - 1);
+	std::vector<pair<uint32_t, uint32_t>> queries(100);
+	for (auto & query : queries) {
+		query = { node(random), node(random) };
+	}
+
+	//-----------------------------------------------------------------------------
+	// Uncached queries, the first one also prepares the weights and the landmarks
+	//-----------------------------------------------------------------------------
+
+	for (const size_t landmarks : { 0, 8, 16 }) {
+		RoutePlanner planner(graph, 0, landmarks);
+		start = chrono::steady_clock::now();
+		planner.find(0, 1);
+		const double prepare = getSeconds(start);
+
+		start = chrono::steady_clock::now();
+		for (const auto & query : queries) {
+			planner.find(query.first, query.second);
+		}
+		printf("%2zu landmarks: prepared in %.3f s, %.1f us per uncached query\n", planner.getLandmarkCount(), prepare,
+		       getSeconds(start) * 1e6 / static_cast<double>(queries.size()));
+	}
+
+	// the landmark bounds must never change the length of a route
+	RoutePlanner plain(graph, 0, 0);
+	RoutePlanner bounded(graph, 0, 8);
+	float worst = 0.0f;
+	for (const auto & query : queries) {
+		const float length = plain.find(query.first, query.second).length;
+		const Route & route = bounded.find(query.first, query.second);
+		if (!isValid(graph, route, query.first, query.second)) {
+			printf("FAIL: invalid route from %u to %u\n", query.first, query.second);
+			return 1;
+		}
+		worst = std::max(worst, std::abs(route.length - length));
+	}
+	printf("every route valid, worst length difference to plain A* %g\n", worst);
+
+	//-----------------------------------------------------------------------------
+	// Dispatch between 64 stations through the cache
+	//-----------------------------------------------------------------------------
+
+	RoutePlanner planner(graph, 4096, 8);
+	std::vector<uint32_t> stations(64);
+	for (uint32_t & station : stations) {
+		station = node(random);
+	}
+	uniform_int_distribution<size_t> pick(0, stations.size() - 1);
+	const size_t count = 200000;
+	start = chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i++) {
+		planner.find(stations[pick(random)], stations[pick(random)]);
+	}
+	printf("dispatch: %zu queries, %.2f us per query, %zu hits, %zu misses\n", count,
+	       getSeconds(start) * 1e6 / static_cast<double>(count), planner.getHits(), planner.getMisses());
+
+	start = chrono::steady_clock::now();
+	for (size_t i = 0; i < count; i++) {
+		planner.find(stations[i % 64], stations[(i / 64) % 64]);
+	}
+	printf("every query a hit: %.3f us per query\n", getSeconds(start) * 1e6 / static_cast<double>(count));
+
+	const size_t misses = planner.getMisses();
+	graph.setSwitch(stations[0], 1);
+	planner.find(stations[0], stations[1]);
+	printf("misses after a switch change: %zu\n", planner.getMisses() - misses);
+	return 0;
+}
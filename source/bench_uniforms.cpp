@@ -0,0 +1,180 @@
+// Microbenchmark of setting the per-object uniforms: a glGetUniformLocation per call as before the location
+// table, names looked up in the table of Shader and the handles Object::draw uses. It runs against a stub GL
+// whose functions only count the calls, so no window or context is needed.
+// Excluded from the windowed project, build it on its own and run it from the repository root, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/bench_uniforms.cpp source/framework/shader.cpp
+//       source/framework/object.cpp source/framework/mesh.cpp source/framework/glad.c -ldl -o bench_uniforms
+// Usage: bench_uniforms [objects] [frames]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "framework/filesystem.h"
+#include "framework/object.h"
+#include "framework/shader.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Stub GL, every uniform of data/shader.vert and data/shader.frag is active
+//-----------------------------------------------------------------------------
+
+static const char * uniformNames[] = { "projection", "view", "model", "albedo",
+                                       "viewPos", "lightDir", "lightColor", "lightAmbient" };
+static const GLint uniformCount = sizeof(uniformNames) / sizeof(uniformNames[0]);
+
+static long locationQueries = 0;
+static long activeQueries = 0;
+static long uploads = 0;
+static long draws = 0;
+static volatile float sink;
+
+// a driver hashes the name, the stub compares it with every active one
+static GLint APIENTRY stubGetUniformLocation(GLuint, const GLchar * name) {
+	locationQueries++;
+	for (GLint i = 0; i < uniformCount; i++) {
+		if (strcmp(uniformNames[i], name) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void APIENTRY stubGetActiveUniform(GLuint, GLuint index, GLsizei, GLsizei * length, GLint * size,
+                                          GLenum * type, GLchar * name) {
+	activeQueries++;
+	strcpy(name, uniformNames[index]);
+	*length = static_cast<GLsizei>(strlen(uniformNames[index]));
+	*size = 1;
+	*type = 0;
+}
+
+static void APIENTRY stubGetProgramiv(GLuint, GLenum name, GLint * value) {
+	*value = name == GL_ACTIVE_UNIFORMS ? uniformCount : name == GL_ACTIVE_UNIFORM_MAX_LENGTH ? 16 : 1;
+}
+
+static void APIENTRY stubGetShaderiv(GLuint, GLenum, GLint * value) {
+	*value = 1;
+}
+
+static void APIENTRY stubUniformMatrix4fv(GLint location, GLsizei, GLboolean, const GLfloat * value) {
+	uploads++;
+	sink = value[0] + static_cast<float>(location);
+}
+
+static void APIENTRY stubUniform3fv(GLint location, GLsizei, const GLfloat * value) {
+	uploads++;
+	sink = value[0] + static_cast<float>(location);
+}
+
+static void APIENTRY stubDrawElements(GLenum, GLsizei, GLenum, const void *) {
+	draws++;
+}
+
+static GLuint APIENTRY stubCreateShader(GLenum) {
+	return 1;
+}
+
+static GLuint APIENTRY stubCreateProgram() {
+	return 1;
+}
+
+static void APIENTRY stubShaderSource(GLuint, GLsizei, const GLchar * const *, const GLint *) {}
+static void APIENTRY stubName(GLuint) {}
+static void APIENTRY stubAttachShader(GLuint, GLuint) {}
+static void APIENTRY stubGenNames(GLsizei, GLuint * names) {
+	*names = 1;
+}
+static void APIENTRY stubDeleteNames(GLsizei, const GLuint *) {}
+static void APIENTRY stubBindBuffer(GLenum, GLuint) {}
+static void APIENTRY stubBufferData(GLenum, GLsizeiptr, const void *, GLenum) {}
+static void APIENTRY stubVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void *) {}
+
+static void loadStubs() {
+	glad_glGetUniformLocation = stubGetUniformLocation;
+	glad_glGetActiveUniform = stubGetActiveUniform;
+	glad_glGetProgramiv = stubGetProgramiv;
+	glad_glGetShaderiv = stubGetShaderiv;
+	glad_glUniformMatrix4fv = stubUniformMatrix4fv;
+	glad_glUniform3fv = stubUniform3fv;
+	glad_glDrawElements = stubDrawElements;
+	glad_glCreateShader = stubCreateShader;
+	glad_glCreateProgram = stubCreateProgram;
+	glad_glShaderSource = stubShaderSource;
+	glad_glCompileShader = stubName;
+	glad_glAttachShader = stubAttachShader;
+	glad_glLinkProgram = stubName;
+	glad_glDeleteShader = stubName;
+	glad_glUseProgram = stubName;
+	glad_glGenVertexArrays = stubGenNames;
+	glad_glGenBuffers = stubGenNames;
+	glad_glDeleteVertexArrays = stubDeleteNames;
+	glad_glDeleteBuffers = stubDeleteNames;
+	glad_glBindVertexArray = stubName;
+	glad_glBindBuffer = stubBindBuffer;
+	glad_glBufferData = stubBufferData;
+	glad_glVertexAttribPointer = stubVertexAttribPointer;
+	glad_glEnableVertexAttribArray = stubName;
+}
+
+// shaders are read from ../data next to the directory returned here
+const char * getAppPath() {
+	return "source/";
+}
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+int main(int argc, char ** argv) {
+	const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+	const size_t frames = argc > 2 ? strtoul(argv[2], nullptr, 10) : 200;
+	loadStubs();
+
+	Shader shader;
+	shader.load("shader.vert", "shader.frag");
+	printf("load: %ld location and %ld active uniform queries, model %d, albedo %d, missing %d\n", locationQueries,
+	       activeQueries, shader.getLocation("model"), shader.getLocation("albedo"), shader.getLocation("missing"));
+
+	Mesh mesh;
+	std::vector<Object> objects(count, Object(&mesh, &shader));
+	const mat4 model(1.0f);
+	const vec3 color(1.0f);
+	const char * modes[] = { "location per call", "location table", "Object::draw handles" };
+	for (int mode = 0; mode < 3; mode++) {
+		locationQueries = 0;
+		uploads = 0;
+		draws = 0;
+		const auto start = chrono::steady_clock::now();
+		for (size_t frame = 0; frame < frames; frame++) {
+			for (Object & object : objects) {
+				if (mode == 0) {
+					glUniformMatrix4fv(glGetUniformLocation(shader.ID, string("model").c_str()), 1, GL_FALSE, &model[0][0]);
+					glUniform3fv(glGetUniformLocation(shader.ID, string("albedo").c_str()), 1, &color[0]);
+				} else if (mode == 1) {
+					shader.setMat4("model", model);
+					shader.setVec3("albedo", color);
+				} else {
+					object.draw();
+				}
+			}
+		}
+		const double seconds = getSeconds(start);
+		const auto perFrame = [frames](const long calls) {
+			return calls / static_cast<long>(frames);
+		};
+		printf("%-21s %6ld location queries, %6ld uploads and %6ld draws per frame, %.1f ns per object\n", modes[mode],
+		       perFrame(locationQueries), perFrame(uploads), perFrame(draws),
+		       seconds * 1e9 / (static_cast<double>(count) * static_cast<double>(frames)));
+	}
+	return 0;
+}
@@ -0,0 +1,232 @@
+#include "bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+
+Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection)
+{
+	// rows of the matrix, the planes are sums and differences of the last row and the others
+	const glm::mat4 m = glm::transpose(viewProjection);
+
+	Frustum result;
+	result.planes[0] = m[3] + m[0]; // left
+	result.planes[1] = m[3] - m[0]; // right
+	result.planes[2] = m[3] + m[1]; // bottom
+	result.planes[3] = m[3] - m[1]; // top
+	result.planes[4] = m[3] + m[2]; // near
+	result.planes[5] = m[3] - m[2]; // far
+	for (int i = 0; i < 6; i++)
+		result.planes[i] /= glm::length(glm::vec3(result.planes[i]));
+	return result;
+}
+
+bool Frustum::intersects(const glm::vec3 &min, const glm::vec3 &max) const
+{
+	if (min.x > max.x)
+		return false;
+
+	// outside when the corner farthest along the normal of some plane is behind it
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec3 normal = glm::vec3(planes[i]);
+		const glm::vec3 corner = glm::vec3(normal.x >= 0.0f ? max.x : min.x, normal.y >= 0.0f ? max.y : min.y,
+			normal.z >= 0.0f ? max.z : min.z);
+		if (glm::dot(normal, corner) + planes[i].w < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+void BVH::build(const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs)
+{
+	numItems = mins.size();
+	nodes.clear();
+	items.resize(numItems);
+	for (size_t i = 0; i < numItems; i++)
+		items[i] = static_cast<unsigned int>(i);
+
+	if (numItems)
+		build_node(mins, maxs, 0, numItems);
+	refit(mins, maxs);
+}
+
+int BVH::build_node(const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs, size_t first, size_t last)
+{
+	// children are created after their parent, so a pass from the back refits every node after its children
+	const int index = static_cast<int>(nodes.size());
+	nodes.emplace_back();
+
+	// split the items into four ranges at the median of the longest extent of their centers, twice
+	size_t bounds[5] = { first, first, first, first, last };
+	const size_t count = last - first;
+	if (count <= 4)
+	{
+		for (size_t i = 0; i < 4; i++)
+			bounds[i + 1] = std::min(first + i + 1, last);
+	}
+	else
+	{
+		auto center = [&mins, &maxs](unsigned int item) { return mins[item] + maxs[item]; };
+		auto split = [this, &center](size_t from, size_t to)
+		{
+			glm::vec3 low(FLT_MAX), high(-FLT_MAX);
+			for (size_t i = from; i < to; i++)
+			{
+				low = glm::min(low, center(items[i]));
+				high = glm::max(high, center(items[i]));
+			}
+			const glm::vec3 extent = high - low;
+			const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+			const size_t middle = from + (to - from) / 2;
+			std::nth_element(items.begin() + from, items.begin() + middle, items.begin() + to,
+				[&center, axis](unsigned int a, unsigned int b) { return center(a)[axis] < center(b)[axis]; });
+			return middle;
+		};
+		bounds[2] = split(first, last);
+		bounds[1] = split(first, bounds[2]);
+		bounds[3] = split(bounds[2], last);
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		int child = Empty;
+		if (bounds[i + 1] - bounds[i] == 1)
+			child = ~static_cast<int>(items[bounds[i]]);
+		else if (bounds[i + 1] > bounds[i])
+			child = build_node(mins, maxs, bounds[i], bounds[i + 1]);
+		nodes[index].children[i] = child;
+	}
+	return index;
+}
+
+void BVH::refit(const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs)
+{
+	for (size_t n = nodes.size(); n-- > 0;)
+	{
+		Node &node = nodes[n];
+		for (int i = 0; i < 4; i++)
+		{
+			// empty children get an inverted box that lies outside of every plane
+			glm::vec3 low(FLT_MAX), high(-FLT_MAX);
+			const int child = node.children[i];
+			if (child != Empty && child < 0)
+			{
+				low = mins[~child];
+				high = maxs[~child];
+			}
+			else if (child != Empty)
+			{
+				const Node &other = nodes[child];
+				for (int j = 0; j < 4; j++)
+				{
+					low = glm::min(low, glm::vec3(other.minX[j], other.minY[j], other.minZ[j]));
+					high = glm::max(high, glm::vec3(other.maxX[j], other.maxY[j], other.maxZ[j]));
+				}
+			}
+			node.minX[i] = low.x;
+			node.minY[i] = low.y;
+			node.minZ[i] = low.z;
+			node.maxX[i] = high.x;
+			node.maxY[i] = high.y;
+			node.maxZ[i] = high.z;
+		}
+	}
+}
+
+void BVH::cull(const Frustum &frustum, std::vector<unsigned int> &visible) const
+{
+	if (nodes.empty())
+		return;
+
+	// a node pushes at most four children and the tree is about log4 of the items deep
+	int stack[64];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node &node = nodes[stack[--top]];
+		int outside, inside;
+		test(node, frustum, outside, inside);
+		for (int i = 0; i < 4; i++)
+		{
+			const int child = node.children[i];
+			if (child == Empty || (outside >> i & 1))
+				continue;
+			// a child inside the frustum takes its whole subtree without further tests
+			if (child < 0)
+				visible.push_back(static_cast<unsigned int>(~child));
+			else if (inside >> i & 1)
+				collect(nodes[child], visible);
+			else
+				stack[top++] = child;
+		}
+	}
+}
+
+void BVH::collect(const Node &node, std::vector<unsigned int> &visible) const
+{
+	for (int i = 0; i < 4; i++)
+	{
+		// items without a box are inside no frustum
+		const int child = node.children[i];
+		if (child == Empty || node.minX[i] > node.maxX[i])
+			continue;
+		if (child < 0)
+			visible.push_back(static_cast<unsigned int>(~child));
+		else
+			collect(nodes[child], visible);
+	}
+}
+
+void BVH::test(const Node &node, const Frustum &frustum, int &outside, int &inside)
+{
+	// a box is outside when its corner farthest along the plane normal is behind the plane and entirely
+	// inside when the nearest one is in front of every plane
+#if defined(BVH_SSE)
+	__m128 out = _mm_setzero_ps();
+	__m128 in = _mm_setzero_ps();
+	const __m128 zero = _mm_setzero_ps();
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec4 &plane = frustum.planes[i];
+		const __m128 a = _mm_set1_ps(plane.x);
+		const __m128 b = _mm_set1_ps(plane.y);
+		const __m128 c = _mm_set1_ps(plane.z);
+		const __m128 d = _mm_set1_ps(plane.w);
+		const __m128 farX = _mm_loadu_ps(plane.x >= 0.0f ? node.maxX : node.minX);
+		const __m128 farY = _mm_loadu_ps(plane.y >= 0.0f ? node.maxY : node.minY);
+		const __m128 farZ = _mm_loadu_ps(plane.z >= 0.0f ? node.maxZ : node.minZ);
+		const __m128 nearX = _mm_loadu_ps(plane.x >= 0.0f ? node.minX : node.maxX);
+		const __m128 nearY = _mm_loadu_ps(plane.y >= 0.0f ? node.minY : node.maxY);
+		const __m128 nearZ = _mm_loadu_ps(plane.z >= 0.0f ? node.minZ : node.maxZ);
+		const __m128 farDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, farX), _mm_mul_ps(b, farY)),
+			_mm_add_ps(_mm_mul_ps(c, farZ), d));
+		const __m128 nearDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, nearX), _mm_mul_ps(b, nearY)),
+			_mm_add_ps(_mm_mul_ps(c, nearZ), d));
+		out = _mm_or_ps(out, _mm_cmplt_ps(farDistance, zero));
+		in = _mm_or_ps(in, _mm_cmplt_ps(nearDistance, zero));
+	}
+	outside = _mm_movemask_ps(out);
+	inside = ~_mm_movemask_ps(in) & 0xf;
+#else
+	outside = 0;
+	inside = 0xf;
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec4 &plane = frustum.planes[i];
+		for (int j = 0; j < 4; j++)
+		{
+			const float farDistance = plane.x * (plane.x >= 0.0f ? node.maxX[j] : node.minX[j]) +
+				plane.y * (plane.y >= 0.0f ? node.maxY[j] : node.minY[j]) +
+				plane.z * (plane.z >= 0.0f ? node.maxZ[j] : node.minZ[j]) + plane.w;
+			const float nearDistance = plane.x * (plane.x >= 0.0f ? node.minX[j] : node.maxX[j]) +
+				plane.y * (plane.y >= 0.0f ? node.minY[j] : node.maxY[j]) +
+				plane.z * (plane.z >= 0.0f ? node.minZ[j] : node.maxZ[j]) + plane.w;
+			if (farDistance < 0.0f)
+				outside |= 1 << j;
+			if (nearDistance < 0.0f)
+				inside &= ~(1 << j);
+		}
+	}
+#endif
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// define BVH_SCALAR to force the scalar box tests
+#if !defined(BVH_SCALAR)
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BVH_SSE
+#include <xmmintrin.h>
+#endif
+#endif
+
+// six planes facing inwards, a point p is inside a plane when dot(plane, vec4(p, 1)) >= 0
+struct Frustum
+{
+	glm::vec4 planes[6];
+
+	// planes of the clip space volume of projection * view
+	static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+	// whether the box [min, max] intersects the frustum or lies inside it, a box with min > max never does
+	bool intersects(const glm::vec3 &min, const glm::vec3 &max) const;
+};
+
+// bounding volume hierarchy over axis-aligned boxes with four children per node, the boxes of the children
+// are stored side by side so that a frustum tests all four at once
+class BVH
+{
+public:
+	// rebuilds the tree over boxes [mins[i], maxs[i]], an item without a box gets min = FLT_MAX and max = -FLT_MAX
+	// and is never visible
+	void build(const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs);
+	// updates the boxes keeping the tree, the item count must be the one of the last build
+	void refit(const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs);
+
+	// appends the items whose boxes intersect the frustum or lie inside it to visible
+	void cull(const Frustum &frustum, std::vector<unsigned int> &visible) const;
+
+	size_t size() const { return numItems; }
+	bool empty() const { return numItems == 0; }
+
+private:
+	// a child is a node index, ~item for an item or Empty
+	enum : int { Empty = 0x7fffffff };
+
+	struct Node
+	{
+		float minX[4], minY[4], minZ[4];
+		float maxX[4], maxY[4], maxZ[4];
+		int children[4];
+	};
+
+	std::vector<Node> nodes;
+	// items in tree order, a build partitions them
+	std::vector<unsigned int> items;
+	size_t numItems = 0;
+
+	int build_node(const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs, size_t first, size_t last);
+	void collect(const Node &node, std::vector<unsigned int> &visible) const;
+	// outside has a bit per child outside the frustum, inside per child entirely within it
+	static void test(const Node &node, const Frustum &frustum, int &outside, int &inside);
+};
@@ -48,7 +48,12 @@ bool Engine::init(int width, int height, const char *title)
 
 	// build and compile shaders
 	shader.load("shader.vert", "shader.frag");
+	instancedShader.load("shader_instanced.vert", "shader.frag");
 	shader.use();
+	frameUniforms = resolveFrameUniforms(shader);
+	instancedFrameUniforms = resolveFrameUniforms(instancedShader);
+	modelUniform = shader.getUniform<glm::mat4>("model");
+	albedoUniform = shader.getUniform<glm::vec3>("albedo");
 
 	// camera
 	camera.Position = glm::vec3(0.0f, 0.0f, 3.0f);
@@ -96,23 +101,98 @@ void Engine::render()
 	// camera
 	glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), window_width / window_height, 0.1f, 100.0f);
 	glm::mat4 view = camera.GetViewMatrix();
+
+	const Frustum frustum = Frustum::fromMatrix(projection * view);
+
+	// render instanced batches and static chunks whose bounds intersect the view frustum
+	numCulledBatches = 0;
+	numCulledChunks = 0;
+	if (!batches.empty() || !chunks.empty())
+	{
+		instancedShader.use();
+		setFrameUniforms(instancedShader, instancedFrameUniforms, projection, view);
+		for (size_t i = 0; i < batches.size(); i++)
+		{
+			batches[i]->updateBounds();
+			if (frustum.intersects(batches[i]->getBoundsMin(), batches[i]->getBoundsMax()))
+				batches[i]->draw();
+			else
+				numCulledBatches++;
+		}
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			if (frustum.intersects(chunks[i]->getMin(), chunks[i]->getMax()))
+				chunks[i]->draw();
+			else
+				numCulledChunks++;
+		}
+	}
+
 	shader.use();
-	shader.setMat4("projection", projection);
-	shader.setMat4("view", view);
-	
-	// light
-	shader.setVec3("viewPos", camera.Position);
-	shader.setVec3("lightDir", -lightDir);
-	shader.setVec3("lightColor", lightColor);
-	shader.setVec3("lightAmbient", lightAmbient);
+	setFrameUniforms(shader, frameUniforms, projection, view);
 
-	// render objects
-	for (int i = 0; i < objects.size(); i++)
-		objects[i]->draw();
+	// render objects that intersect the view frustum
+	cullObjects(frustum);
+	for (size_t i = 0; i < visible.size(); i++)
+		objects[visible[i]]->draw();
 
 	// restore to default
-	shader.setMat4("model", glm::mat4(1.0f));
-	shader.setVec3("albedo", glm::vec3(1.0f));
+	shader.set(modelUniform, glm::mat4(1.0f));
+	shader.set(albedoUniform, glm::vec3(1.0f));
+}
+
+void Engine::cullObjects(const Frustum &frustum)
+{
+	// objects that moved get new bounds, the tree is rebuilt when objects were added or removed
+	// and only refitted when some of them moved
+	bool moved = false;
+	boundsMin.resize(objects.size());
+	boundsMax.resize(objects.size());
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		if (objects[i]->updateBounds() || objectsChanged)
+		{
+			boundsMin[i] = objects[i]->getBoundsMin();
+			boundsMax[i] = objects[i]->getBoundsMax();
+			moved = true;
+		}
+	}
+	if (objectsChanged)
+		bvh.build(boundsMin, boundsMax);
+	else if (moved)
+		bvh.refit(boundsMin, boundsMax);
+	objectsChanged = false;
+
+	visible.clear();
+	bvh.cull(frustum, visible);
+	numDrawnObjects = visible.size();
+	numCulledObjects = objects.size() - visible.size();
+}
+
+Engine::FrameUniforms Engine::resolveFrameUniforms(const Shader &target)
+{
+	FrameUniforms uniforms;
+	uniforms.projection = target.getUniform<glm::mat4>("projection");
+	uniforms.view = target.getUniform<glm::mat4>("view");
+	uniforms.viewPos = target.getUniform<glm::vec3>("viewPos");
+	uniforms.lightDir = target.getUniform<glm::vec3>("lightDir");
+	uniforms.lightColor = target.getUniform<glm::vec3>("lightColor");
+	uniforms.lightAmbient = target.getUniform<glm::vec3>("lightAmbient");
+	return uniforms;
+}
+
+void Engine::setFrameUniforms(const Shader &target, const FrameUniforms &uniforms, const glm::mat4 &projection,
+	const glm::mat4 &view)
+{
+	// camera
+	target.set(uniforms.projection, projection);
+	target.set(uniforms.view, view);
+
+	// light
+	target.set(uniforms.viewPos, camera.Position);
+	target.set(uniforms.lightDir, -lightDir);
+	target.set(uniforms.lightColor, lightColor);
+	target.set(uniforms.lightAmbient, lightAmbient);
 }
 
 void Engine::swap()
@@ -128,6 +208,17 @@ void Engine::shutdown()
 	for (int i = 0; i < objects.size(); i++)
 		delete objects[i];
 	objects.clear();
+	objectsChanged = true;
+
+	// destroy batches
+	for (size_t i = 0; i < batches.size(); i++)
+		delete batches[i];
+	batches.clear();
+
+	// destroy static chunks
+	for (size_t i = 0; i < chunks.size(); i++)
+		delete chunks[i];
+	chunks.clear();
 
 	glfwTerminate();
 }
@@ -136,6 +227,7 @@ Object *Engine::createObject()
 {
 	Object *obj = new Object(&shader);
 	objects.push_back(obj);
+	objectsChanged = true;
 	return obj;
 }
 
@@ -143,6 +235,7 @@ Object *Engine::createObject(Mesh *mesh)
 {
 	Object *obj = new Object(mesh, &shader);
 	objects.push_back(obj);
+	objectsChanged = true;
 	return obj;
 }
 
@@ -150,6 +243,7 @@ void Engine::deleteObject(int index)
 {
 	delete objects[index];
 	objects.erase(objects.begin() + index);
+	objectsChanged = true;
 }
 
 void Engine::deleteObject(Object *obj)
@@ -159,9 +253,44 @@ void Engine::deleteObject(Object *obj)
 		return;
 
 	objects.erase(it);
+	objectsChanged = true;
 	delete obj;
 }
 
+InstancedBatch *Engine::createBatch(Mesh *mesh)
+{
+	InstancedBatch *batch = new InstancedBatch(mesh);
+	batches.push_back(batch);
+	return batch;
+}
+
+void Engine::deleteBatch(InstancedBatch *batch)
+{
+	auto it = std::find(batches.begin(), batches.end(), batch);
+	if (it == batches.end())
+		return;
+
+	batches.erase(it);
+	delete batch;
+}
+
+StaticChunk *Engine::createChunk()
+{
+	StaticChunk *chunk = new StaticChunk();
+	chunks.push_back(chunk);
+	return chunk;
+}
+
+void Engine::deleteChunk(StaticChunk *chunk)
+{
+	auto it = std::find(chunks.begin(), chunks.end(), chunk);
+	if (it == chunks.end())
+		return;
+
+	chunks.erase(it);
+	delete chunk;
+}
+
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
 void Engine::processInput(GLFWwindow *window)
 {
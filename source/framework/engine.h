@@ -12,6 +12,9 @@
 #include "camera.h"
 #include "shader.h"
 #include "object.h"
+#include "instanced_batch.h"
+#include "static_chunk.h"
+#include "bvh.h"
 
 class Engine
 {
@@ -35,9 +38,28 @@ public:
 	Object *getObject(int index) { return objects[index]; }
 	void deleteObject(int index);
 	void deleteObject(Object *obj);
+	// objects drawn and culled by the view frustum in the last render
+	size_t getNumDrawnObjects() const { return numDrawnObjects; }
+	size_t getNumCulledObjects() const { return numCulledObjects; }
+	// batches and chunks culled as a whole by their bounds in the last render
+	size_t getNumCulledBatches() const { return numCulledBatches; }
+	size_t getNumCulledChunks() const { return numCulledChunks; }
+
+	// instanced batches, each drawn with one call before the objects unless its bounds are outside the view
+	InstancedBatch *createBatch(Mesh *mesh);
+	size_t getNumBatches() const { return batches.size(); }
+	InstancedBatch *getBatch(int index) { return batches[index]; }
+	void deleteBatch(InstancedBatch *batch);
+
+	// static chunks of merged geometry, each drawn with one call after the batches unless outside the view
+	StaticChunk *createChunk();
+	size_t getNumChunks() const { return chunks.size(); }
+	StaticChunk *getChunk(int index) { return chunks[index]; }
+	void deleteChunk(StaticChunk *chunk);
 
 	// material
 	Shader &getShader() { return shader; }
+	Shader &getInstancedShader() { return instancedShader; }
 
 	// environment
 	void setEnvironmentColor(const glm::vec3 &color) { envColor = color; }
@@ -68,6 +90,23 @@ private:
 	static void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 	static void processInput(GLFWwindow *window);
 
+	// collects the objects whose bounds intersect the frustum into visible
+	void cullObjects(const Frustum &frustum);
+
+	// camera and light uniforms shared by all shaders, resolved once per shader after it is loaded
+	struct FrameUniforms
+	{
+		Uniform<glm::mat4> projection;
+		Uniform<glm::mat4> view;
+		Uniform<glm::vec3> viewPos;
+		Uniform<glm::vec3> lightDir;
+		Uniform<glm::vec3> lightColor;
+		Uniform<glm::vec3> lightAmbient;
+	};
+	static FrameUniforms resolveFrameUniforms(const Shader &target);
+	void setFrameUniforms(const Shader &target, const FrameUniforms &uniforms, const glm::mat4 &projection,
+		const glm::mat4 &view);
+
 	// window
 	GLFWwindow *window = nullptr;
 	float window_width;
@@ -82,7 +121,25 @@ private:
 
 	// objects
 	Shader shader;
+	FrameUniforms frameUniforms;
+	Uniform<glm::mat4> modelUniform;
+	Uniform<glm::vec3> albedoUniform;
 	std::vector<Object *> objects;
+	Shader instancedShader;
+	FrameUniforms instancedFrameUniforms;
+	std::vector<InstancedBatch *> batches;
+	std::vector<StaticChunk *> chunks;
+
+	// frustum culling, the bounds are indexed like the objects
+	BVH bvh;
+	bool objectsChanged = true;
+	std::vector<glm::vec3> boundsMin;
+	std::vector<glm::vec3> boundsMax;
+	std::vector<unsigned int> visible;
+	size_t numDrawnObjects = 0;
+	size_t numCulledObjects = 0;
+	size_t numCulledBatches = 0;
+	size_t numCulledChunks = 0;
 
 	// environment
 	glm::vec3 envColor;
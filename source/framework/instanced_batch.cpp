@@ -0,0 +1,126 @@
+#include "instanced_batch.h"
+
+InstancedBatch::InstancedBatch(Mesh *mesh) : mesh(mesh)
+{
+	init_buffers();
+}
+
+InstancedBatch::~InstancedBatch()
+{
+	shutdown_buffers();
+}
+
+size_t InstancedBatch::add(const glm::mat4 &model, const glm::vec3 &color)
+{
+	instances.push_back({model, color});
+	dirty = true;
+	moved = true;
+	return instances.size() - 1;
+}
+
+void InstancedBatch::set(size_t index, const glm::mat4 &model, const glm::vec3 &color)
+{
+	instances[index] = {model, color};
+	dirty = true;
+	moved = true;
+}
+
+void InstancedBatch::clear()
+{
+	instances.clear();
+	dirty = true;
+	moved = true;
+}
+
+bool InstancedBatch::updateBounds()
+{
+	if (!moved && (!mesh || mesh->getRevision() == meshRevision))
+		return false;
+	moved = false;
+
+	boundsMin = glm::vec3(FLT_MAX);
+	boundsMax = glm::vec3(-FLT_MAX);
+	if (!mesh)
+		return true;
+	meshRevision = mesh->getRevision();
+
+	// the box around every transformed mesh box, computed like the bounds of an object
+	const glm::vec3 center = (mesh->getMin() + mesh->getMax()) * 0.5f;
+	const glm::vec3 extent = (mesh->getMax() - mesh->getMin()) * 0.5f;
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		const glm::mat4 &t = instances[i].model;
+		const glm::vec3 worldCenter = glm::vec3(t * glm::vec4(center, 1.0f));
+		glm::vec3 worldExtent = glm::vec3(0.0f);
+		for (int j = 0; j < 3; j++)
+			worldExtent += glm::abs(glm::vec3(t[j])) * extent[j];
+		boundsMin = glm::min(boundsMin, worldCenter - worldExtent);
+		boundsMax = glm::max(boundsMax, worldCenter + worldExtent);
+	}
+	return true;
+}
+
+void InstancedBatch::draw(GLenum mode)
+{
+	if (!mesh || instances.empty())
+		return;
+
+	update_buffers();
+
+	// draw all instances of the mesh
+	glBindVertexArray(VAO);
+	glDrawElementsInstanced(mode, static_cast<GLsizei>(mesh->getIndices().size()), GL_UNSIGNED_INT, 0,
+		static_cast<GLsizei>(instances.size()));
+	glBindVertexArray(0);
+}
+
+void InstancedBatch::init_buffers()
+{
+	// create buffers/arrays
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &instanceVBO);
+
+	glBindVertexArray(VAO);
+	if (mesh)
+		mesh->bindBuffers();
+
+	// set the instance attribute pointers, advanced once per instance:
+	// model matrix, one column per location
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	for (int i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(3 + i);
+		glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			(void*)(offsetof(Instance, model) + i * sizeof(glm::vec4)));
+		glVertexAttribDivisor(3 + i, 1);
+	}
+	// color
+	glEnableVertexAttribArray(7);
+	glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, color));
+	glVertexAttribDivisor(7, 1);
+
+	glBindVertexArray(0);
+}
+
+void InstancedBatch::update_buffers()
+{
+	if (!dirty)
+		return;
+
+	// grow the buffer when needed, otherwise only replace its contents
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	if (instances.size() > capacity)
+	{
+		capacity = instances.capacity();
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Instance), nullptr, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(Instance), instances.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	dirty = false;
+}
+
+void InstancedBatch::shutdown_buffers()
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &instanceVBO);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cfloat>
+#include <vector>
+#include "mesh.h"
+
+// per-instance data, read by the instanced vertex shader from the instance buffer
+struct Instance
+{
+	glm::mat4 model;
+	glm::vec3 color;
+};
+
+// copies of one mesh drawn with a single call, each with its own transformation and color
+class InstancedBatch
+{
+public:
+	InstancedBatch(Mesh *mesh);
+	~InstancedBatch();
+
+	InstancedBatch(const InstancedBatch &) = delete;
+	InstancedBatch &operator=(const InstancedBatch &) = delete;
+
+	// instances, changes are uploaded on the next draw
+	size_t add(const glm::mat4 &model, const glm::vec3 &color);
+	void set(size_t index, const glm::mat4 &model, const glm::vec3 &color);
+	void clear();
+	void reserve(size_t count) { instances.reserve(count); }
+	size_t size() const { return instances.size(); }
+	const Instance &get(size_t index) const { return instances[index]; }
+
+	Mesh *getMesh() const { return mesh; }
+
+	// world bounds of all instances, an empty batch has none: min = FLT_MAX and max = -FLT_MAX
+	const glm::vec3 &getBoundsMin() const { return boundsMin; }
+	const glm::vec3 &getBoundsMax() const { return boundsMax; }
+	// recomputes the bounds if the instances or the mesh changed since the last call, returns whether it did
+	bool updateBounds();
+
+	// draw all instances, expects the instanced shader to be in use
+	void draw(GLenum mode = GL_TRIANGLES);
+
+private:
+	Mesh *mesh = nullptr;
+	std::vector<Instance> instances;
+	bool dirty = false;
+	// instances the buffer has room for
+	size_t capacity = 0;
+
+	// world bounds, valid as long as no instance changed and the mesh revision did not change
+	glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+	glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+	bool moved = true;
+	unsigned int meshRevision = 0;
+
+	// render data
+	unsigned int VAO = 0;         // vertex arrays object sharing the buffers of the mesh
+	unsigned int instanceVBO = 0; // instance buffer object
+
+	// buffer objects/arrays
+	void init_buffers();
+	void update_buffers();
+	void shutdown_buffers();
+};
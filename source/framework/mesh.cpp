@@ -11,6 +11,7 @@ Mesh::Mesh(const vector<Vertex> &vertices, const vector<unsigned int> &indices)
 {
 	this->vertices = vertices;
 	this->indices = indices;
+	update_bounds();
 
 	// now that we have all the required data, set the vertex buffers and its attribute pointers.
 	init_buffers();
@@ -25,6 +26,7 @@ void Mesh::clear()
 {
 	vertices.clear();
 	indices.clear();
+	update_bounds();
 	update_buffers();
 }
 
@@ -32,6 +34,7 @@ void Mesh::set(const vector<Vertex> &vertices, const vector<unsigned int> &indic
 {
 	this->vertices = vertices;
 	this->indices = indices;
+	update_bounds();
 	update_buffers();
 }
 
@@ -66,6 +69,20 @@ void Mesh::update_buffers()
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
 
+	set_attributes();
+
+	glBindVertexArray(0);
+}
+
+void Mesh::bindBuffers() const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	set_attributes();
+}
+
+void Mesh::set_attributes()
+{
 	// set the vertex attribute pointers:
 	// vertex positions
 	glEnableVertexAttribArray(0);
@@ -76,8 +93,17 @@ void Mesh::update_buffers()
 	// vertex texture coords
 	glEnableVertexAttribArray(2);
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex_coords));
-		
-	glBindVertexArray(0);
+}
+
+void Mesh::update_bounds()
+{
+	boundsMin = boundsMax = vertices.empty() ? glm::vec3(0.0f) : vertices[0].position;
+	for (size_t i = 1; i < vertices.size(); i++)
+	{
+		boundsMin = glm::min(boundsMin, vertices[i].position);
+		boundsMax = glm::max(boundsMax, vertices[i].position);
+	}
+	revision++;
 }
 
 void Mesh::shutdown_buffers()
@@ -27,13 +27,25 @@ public:
 	const std::vector<Vertex> &getVertices() const { return vertices; }
 	const std::vector<unsigned int> &getIndices() const { return indices; }
 
+	// bounds of the vertex positions, the revision changes whenever they may have changed
+	const glm::vec3 &getMin() const { return boundsMin; }
+	const glm::vec3 &getMax() const { return boundsMax; }
+	unsigned int getRevision() const { return revision; }
+
 	// render the mesh
 	void draw(GLenum mode = GL_TRIANGLES);
 
+	// bind the vertex and element buffers with their attributes to the currently bound vertex array,
+	// so that other vertex arrays can share them
+	void bindBuffers() const;
+
 private:
 	// mesh data
 	std::vector<Vertex>       vertices;
 	std::vector<unsigned int> indices;
+	glm::vec3 boundsMin = glm::vec3(0.0f);
+	glm::vec3 boundsMax = glm::vec3(0.0f);
+	unsigned int revision = 0;
 
 	// render data
 	unsigned int VAO = 0; // vertex arrays object
@@ -44,6 +56,8 @@ private:
 	void init_buffers();
 	void update_buffers();
 	void shutdown_buffers();
+	void update_bounds();
+	static void set_attributes();
 };
 
 // helpers, built-in meshes
@@ -6,20 +6,59 @@ void Object::setRotation(float pitch_deg, float yaw_deg, float roll_deg)
 	setRotation(glm::quat(euler));
 }
 
-void Object::draw()
+glm::mat4 Object::getTransform() const
 {
-	if (!shader || !mesh)
-		return;
-
 	// make transformation matrix
 	glm::mat4 t = glm::mat4(1.0f);
 	t = glm::translate(t, position);
 	t = t * glm::mat4_cast(rotation);
 	t = glm::scale(t, scale);
+	return t;
+}
+
+bool Object::updateBounds()
+{
+	if (!moved && (!mesh || mesh->getRevision() == meshRevision))
+		return false;
+	moved = false;
+
+	if (!mesh)
+	{
+		boundsMin = glm::vec3(FLT_MAX);
+		boundsMax = glm::vec3(-FLT_MAX);
+		return true;
+	}
+	meshRevision = mesh->getRevision();
+
+	// the box around the transformed mesh box: the center is transformed and the extent grows by the
+	// absolute values of the matrix
+	const glm::mat4 t = getTransform();
+	const glm::vec3 center = glm::vec3(t * glm::vec4((mesh->getMin() + mesh->getMax()) * 0.5f, 1.0f));
+	const glm::vec3 extent = (mesh->getMax() - mesh->getMin()) * 0.5f;
+	glm::vec3 worldExtent = glm::vec3(0.0f);
+	for (int i = 0; i < 3; i++)
+		worldExtent += glm::abs(glm::vec3(t[i])) * extent[i];
+	boundsMin = center - worldExtent;
+	boundsMax = center + worldExtent;
+	return true;
+}
+
+void Object::resolveUniforms()
+{
+	if (!shader)
+		return;
+	modelUniform = shader->getUniform<glm::mat4>("model");
+	albedoUniform = shader->getUniform<glm::vec3>("albedo");
+}
+
+void Object::draw()
+{
+	if (!shader || !mesh)
+		return;
 
 	// set material
-	shader->setMat4("model", t);
-	shader->setVec3("albedo", color);
+	shader->set(modelUniform, getTransform());
+	shader->set(albedoUniform, color);
 	
 	// draw mesh
 	mesh->draw();
@@ -3,33 +3,41 @@
 #include "mesh.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <cfloat>
 
 class Object
 {
 public:
 	Object() {}
-	Object(Shader *shader) : shader(shader) {}
-	Object(Mesh *mesh, Shader *shader) : mesh(mesh), shader(shader) {}
+	Object(Shader *shader) : shader(shader) { resolveUniforms(); }
+	Object(Mesh *mesh, Shader *shader) : mesh(mesh), shader(shader) { resolveUniforms(); }
 
 	// mesh
-	void setMesh(Mesh *mesh) { this->mesh = mesh; }
+	void setMesh(Mesh *mesh) { this->mesh = mesh; moved = true; }
 	Mesh *getMesh() const { return mesh; }
 
 	// transformation
-	void setPosition(const glm::vec3 &position) { this->position = position; }
-	void setPosition(float x, float y, float z) { this->position = glm::vec3(x, y, z); }
-	void setRotation(const glm::quat &rotation) { this->rotation = rotation; }
+	void setPosition(const glm::vec3 &position) { this->position = position; moved = true; }
+	void setPosition(float x, float y, float z) { this->position = glm::vec3(x, y, z); moved = true; }
+	void setRotation(const glm::quat &rotation) { this->rotation = rotation; moved = true; }
 	void setRotation(float pitch_deg, float yaw_deg, float roll_deg);
-	void setScale(const glm::vec3 &scale) { this->scale = scale; }
-	void setScale(float x, float y, float z) { this->scale = glm::vec3(x, y, z); }
-	void setScale(float s) { this->scale = glm::vec3(s); }
+	void setScale(const glm::vec3 &scale) { this->scale = scale; moved = true; }
+	void setScale(float x, float y, float z) { this->scale = glm::vec3(x, y, z); moved = true; }
+	void setScale(float s) { this->scale = glm::vec3(s); moved = true; }
 
 	const glm::vec3 &getPosition() const { return position; }
 	const glm::quat &getRotation() const { return rotation; }
 	const glm::vec3 &getScale() const { return scale; }
+	glm::mat4 getTransform() const;
+
+	// world bounds of the mesh, an object without a mesh has none: min = FLT_MAX and max = -FLT_MAX
+	const glm::vec3 &getBoundsMin() const { return boundsMin; }
+	const glm::vec3 &getBoundsMax() const { return boundsMax; }
+	// recomputes the bounds if the object or its mesh changed since the last call, returns whether it did
+	bool updateBounds();
 
 	// material parameters
-	void setShader(Shader *shader) { this->shader = shader; }
+	void setShader(Shader *shader) { this->shader = shader; resolveUniforms(); }
 	Shader *getShader() const { return shader; }
 
 	void setColor(const glm::vec3 &color) { this->color = color; }
@@ -40,14 +48,25 @@ public:
 	void draw();
 
 private:
+	// looks up the uniforms draw sets once instead of on every draw
+	void resolveUniforms();
+
 	Mesh *mesh = nullptr;
 	Shader *shader = nullptr;
+	Uniform<glm::mat4> modelUniform;
+	Uniform<glm::vec3> albedoUniform;
 
 	// model transformation
 	glm::vec3 position = glm::vec3(0, 0, 0);
 	glm::quat rotation = glm::quat(1, 0, 0, 0);
 	glm::vec3 scale = glm::vec3(1, 1, 1);
 
+	// world bounds, valid as long as the object did not move and the mesh revision did not change
+	glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+	glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+	bool moved = true;
+	unsigned int meshRevision = 0;
+
 	// material
 	glm::vec3 color = glm::vec3(1.0f);
 };
\ No newline at end of file
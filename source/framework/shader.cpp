@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -66,6 +67,14 @@ void Shader::load(const char *vertexPath, const char *fragmentPath)
 	// delete the shaders as they're linked into our program now and no longer necessery
 	glDeleteShader(vertex);
 	glDeleteShader(fragment);
+	// 3. cache the uniform locations so that setting a uniform never asks the driver for one
+	reflectUniforms();
+}
+
+GLint Shader::getLocation(const std::string &name) const
+{
+	auto it = locations.find(name);
+	return it == locations.end() ? -1 : it->second;
 }
 
 void Shader::use() const
@@ -75,59 +84,130 @@ void Shader::use() const
 
 void Shader::setBool(const std::string &name, bool value) const
 {         
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+	glUniform1i(getLocation(name), (int)value); 
 }
 
 void Shader::setInt(const std::string &name, int value) const
 { 
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+	glUniform1i(getLocation(name), value); 
 }
 
 void Shader::setFloat(const std::string &name, float value) const
 { 
-	glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+	glUniform1f(getLocation(name), value); 
 }
 
 void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
 { 
-	glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+	glUniform2fv(getLocation(name), 1, &value[0]); 
 }
 void Shader::setVec2(const std::string &name, float x, float y) const
 { 
-	glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+	glUniform2f(getLocation(name), x, y); 
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
 { 
-	glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+	glUniform3fv(getLocation(name), 1, &value[0]); 
 }
 void Shader::setVec3(const std::string &name, float x, float y, float z) const
 { 
-	glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+	glUniform3f(getLocation(name), x, y, z); 
 }
 
 void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
 { 
-	glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+	glUniform4fv(getLocation(name), 1, &value[0]); 
 }
 void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const
 { 
-	glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+	glUniform4f(getLocation(name), x, y, z, w); 
 }
 
 void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const
 {
-	glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	glUniformMatrix2fv(getLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
 {
-	glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	glUniformMatrix3fv(getLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
 {
-	glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	glUniformMatrix4fv(getLocation(name), 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::set(Uniform<bool> uniform, bool value) const
+{
+	glUniform1i(uniform.location, (int)value);
+}
+
+void Shader::set(Uniform<int> uniform, int value) const
+{
+	glUniform1i(uniform.location, value);
+}
+
+void Shader::set(Uniform<float> uniform, float value) const
+{
+	glUniform1f(uniform.location, value);
+}
+
+void Shader::set(Uniform<glm::vec2> uniform, const glm::vec2 &value) const
+{
+	glUniform2fv(uniform.location, 1, &value[0]);
+}
+
+void Shader::set(Uniform<glm::vec3> uniform, const glm::vec3 &value) const
+{
+	glUniform3fv(uniform.location, 1, &value[0]);
+}
+
+void Shader::set(Uniform<glm::vec4> uniform, const glm::vec4 &value) const
+{
+	glUniform4fv(uniform.location, 1, &value[0]);
+}
+
+void Shader::set(Uniform<glm::mat2> uniform, const glm::mat2 &mat) const
+{
+	glUniformMatrix2fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::set(Uniform<glm::mat3> uniform, const glm::mat3 &mat) const
+{
+	glUniformMatrix3fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::set(Uniform<glm::mat4> uniform, const glm::mat4 &mat) const
+{
+	glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::reflectUniforms()
+{
+	locations.clear();
+	GLint count = 0;
+	GLint maxLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	std::vector<GLchar> buffer(maxLength > 0 ? maxLength : 1);
+	for (GLint i = 0; i < count; i++)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, (GLuint)i, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
+		std::string name(buffer.data(), length);
+		// uniforms inside blocks have no location of their own
+		GLint location = glGetUniformLocation(ID, name.c_str());
+		if (location < 0)
+			continue;
+		locations[name] = location;
+		// arrays are reported as their first element, make them reachable by their plain name too
+		if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+			locations[name.substr(0, name.size() - 3)] = location;
+	}
 }
 
 void Shader::checkCompileErrors(GLuint shader, std::string type)
@@ -3,15 +3,35 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <string>
+#include <unordered_map>
+
+// location of a uniform resolved once, typed so that it can only be set to values of its type
+template <typename T>
+struct Uniform
+{
+	GLint location;
+
+	explicit Uniform(GLint location = -1) : location(location) {}
+
+	// false for names the program has no active uniform for, setting it then does nothing
+	bool isValid() const { return location >= 0; }
+};
 
 class Shader
 {
 public:
 	unsigned int ID;
 	
-	// constructor generates the shader on the fly
+	// constructor generates the shader on the fly and reads the locations of all active uniforms
 	void load(const char *vertexPath, const char *fragmentPath);
 
+	// location from the table built by load without asking the driver, -1 if there is no such uniform
+	GLint getLocation(const std::string &name) const;
+
+	// handles stay valid until the shader is loaded again
+	template <typename T>
+	Uniform<T> getUniform(const std::string &name) const { return Uniform<T>(getLocation(name)); }
+
 	// activate the shader
 	void use() const;
 
@@ -45,7 +65,23 @@ public:
 	// ------------------------------------------------------------------------
 	void setMat4(const std::string &name, const glm::mat4 &mat) const;
 
+	// same through pre-resolved handles, for uniforms set many times per frame
+	void set(Uniform<bool> uniform, bool value) const;
+	void set(Uniform<int> uniform, int value) const;
+	void set(Uniform<float> uniform, float value) const;
+	void set(Uniform<glm::vec2> uniform, const glm::vec2 &value) const;
+	void set(Uniform<glm::vec3> uniform, const glm::vec3 &value) const;
+	void set(Uniform<glm::vec4> uniform, const glm::vec4 &value) const;
+	void set(Uniform<glm::mat2> uniform, const glm::mat2 &mat) const;
+	void set(Uniform<glm::mat3> uniform, const glm::mat3 &mat) const;
+	void set(Uniform<glm::mat4> uniform, const glm::mat4 &mat) const;
+
 private:
 	// utility function for checking shader compilation/linking errors.
 	void checkCompileErrors(GLuint shader, std::string type);
+
+	// reads the names and locations of all active uniforms of the linked program
+	void reflectUniforms();
+
+	std::unordered_map<std::string, GLint> locations;
 };
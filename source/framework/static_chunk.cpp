@@ -0,0 +1,72 @@
+#include "static_chunk.h"
+
+StaticChunk::StaticChunk()
+{
+	init_buffers();
+}
+
+StaticChunk::~StaticChunk()
+{
+	shutdown_buffers();
+}
+
+void StaticChunk::set(const std::vector<StaticVertex> &vertices, const std::vector<unsigned int> &indices)
+{
+	numIndices = indices.size();
+	min = max = vertices.empty() ? glm::vec3(0.0f) : vertices[0].position;
+	for (size_t i = 1; i < vertices.size(); i++)
+	{
+		min = glm::min(min, vertices[i].position);
+		max = glm::max(max, vertices[i].position);
+	}
+
+	// the element buffer binding is part of the vertex array state
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(StaticVertex), vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+	glBindVertexArray(0);
+}
+
+void StaticChunk::draw(GLenum mode)
+{
+	if (!numIndices)
+		return;
+
+	// the model matrix locations are no arrays here, so the shader reads the current generic values:
+	// the identity, one column per location
+	for (int i = 0; i < 4; i++)
+		glVertexAttrib4f(3 + i, i == 0 ? 1.0f : 0.0f, i == 1 ? 1.0f : 0.0f, i == 2 ? 1.0f : 0.0f, i == 3 ? 1.0f : 0.0f);
+
+	glBindVertexArray(VAO);
+	glDrawElements(mode, static_cast<GLsizei>(numIndices), GL_UNSIGNED_INT, 0);
+	glBindVertexArray(0);
+}
+
+void StaticChunk::init_buffers()
+{
+	// create buffers/arrays
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+
+	// set the vertex attribute pointers:
+	// vertex positions, normals and colors at the location of the instance color
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, normal));
+	glEnableVertexAttribArray(7);
+	glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, color));
+	glBindVertexArray(0);
+}
+
+void StaticChunk::shutdown_buffers()
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+}
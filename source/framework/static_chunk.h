@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// vertex of static geometry with its transformation and color baked in
+struct StaticVertex
+{
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec3 color;
+};
+
+// static geometry of a region merged into one vertex and one element buffer and drawn with a single call,
+// it is drawn with the instanced shader as one instance with the identity transformation
+class StaticChunk
+{
+public:
+	StaticChunk();
+	~StaticChunk();
+
+	StaticChunk(const StaticChunk &) = delete;
+	StaticChunk &operator=(const StaticChunk &) = delete;
+
+	// replaces the geometry, it is uploaded at once and not kept on the CPU
+	void set(const std::vector<StaticVertex> &vertices, const std::vector<unsigned int> &indices);
+	size_t getNumIndices() const { return numIndices; }
+
+	// bounds of the vertices
+	const glm::vec3 &getMin() const { return min; }
+	const glm::vec3 &getMax() const { return max; }
+
+	// draw the chunk, expects the instanced shader to be in use
+	void draw(GLenum mode = GL_TRIANGLES);
+
+private:
+	size_t numIndices = 0;
+	glm::vec3 min = glm::vec3(0.0f);
+	glm::vec3 max = glm::vec3(0.0f);
+
+	// render data
+	unsigned int VAO = 0; // vertex arrays object
+	unsigned int VBO = 0; // vertex buffer object
+	unsigned int EBO = 0; // element buffer object
+
+	// buffer objects/arrays
+	void init_buffers();
+	void shutdown_buffers();
+};
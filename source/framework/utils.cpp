@@ -4,11 +4,13 @@
 LineDrawer::LineDrawer(const float *points, size_t count, bool loop)
 {
 	setPoints(points, count, loop);
+	resolveUniforms();
 }
 
 LineDrawer::LineDrawer(const std::vector<glm::vec3> &points, bool loop)
 {
 	setPoints(points, loop);
+	resolveUniforms();
 }
 
 void LineDrawer::setPoints(const float *points, size_t count, bool loop)
@@ -55,10 +57,17 @@ void LineDrawer::setPoints(const std::vector<glm::vec3> &points, bool loop)
 	mesh.set(v, i);
 }
 
+void LineDrawer::resolveUniforms()
+{
+	const Shader &shader = Engine::get()->getShader();
+	modelUniform = shader.getUniform<glm::mat4>("model");
+	albedoUniform = shader.getUniform<glm::vec3>("albedo");
+}
+
 void LineDrawer::draw()
 {
-	Engine *engine = Engine::get();
-	engine->getShader().setMat4("model", glm::mat4(1.0f));
-	engine->getShader().setVec3("albedo", color);
+	const Shader &shader = Engine::get()->getShader();
+	shader.set(modelUniform, glm::mat4(1.0f));
+	shader.set(albedoUniform, color);
 	mesh.draw(GL_LINES);
 }
\ No newline at end of file
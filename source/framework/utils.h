@@ -1,5 +1,6 @@
 #pragma once
 #include "mesh.h"
+#include "shader.h"
 
 class LineDrawer
 {
@@ -17,6 +18,11 @@ public:
 	void draw();
 
 private:
+	// looks up the uniforms draw sets once instead of on every draw
+	void resolveUniforms();
+
 	Mesh mesh;
 	glm::vec3 color = glm::vec3(1.0f);
+	Uniform<glm::mat4> modelUniform;
+	Uniform<glm::vec3> albedoUniform;
 };
\ No newline at end of file
@@ -0,0 +1,101 @@
+// Simulation without a window or GL context, for capacity studies on servers.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -pthread -Iinclude -Isource source/headless.cpp -o headless
+// Usage: headless [trains] [ticks] [threads] [fixed]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "solution/lockstep.h"
+#include "solution/track_geometry.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Global settings
+//-----------------------------------------------------------------------------
+
+#define SETTINGS_SPLINE_EPS		    0.01f
+#define SETTINGS_TIES_COUNT			std::pow(2, 7)
+#define SETTINGS_RAILS_WIDTH		1.3f
+#define SETTINGS_RAILS_TRACK_WIDTH  0.2f
+#define SETTINGS_TRAIN_SPEED        1.2f
+#define SETTINGS_TRAIN_ACCELERATION 0.4f
+#define SETTINGS_TRAIN_BRAKING      0.8f
+#define SETTINGS_CARS_COUNT         4
+#define SETTINGS_CARS_COUPLING      1.4f
+#define SETTINGS_FIXED_TIMESTEP     (1.0f / 60.0f)
+
+#define SETTINGS_IS_LOOP true
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+int main(int argc, char ** argv) {
+	const size_t trains = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2500;
+	const size_t ticks = argc > 2 ? strtoul(argv[2], nullptr, 10) : 3600;
+	const size_t threads = argc > 3 ? strtoul(argv[3], nullptr, 10) : 0;
+	const bool isFixedPoint = argc > 4 && strcmp(argv[4], "fixed") == 0;
+
+	// same track as the windowed demo
+	const std::vector<vec3> controlPoints = {
+		{ 0.0f, -0.375f, 7.0f },
+		{ -6.0f, -0.375f, 5.0f },
+		{ -8.0f, -0.375f, 1.0f },
+		{ -4.0f, -0.375f, -6.0f },
+		{ 0.0f, -0.375f, -7.0f },
+		{ 1.0f, -0.375f, -4.0f },
+		{ 4.0f, -0.375f, -3.0f },
+		{ 8.0f, -0.375f, 7.0f }
+	};
+
+	//-----------------------------------------------------------------------------
+	// Constructing spline and track geometry
+	//-----------------------------------------------------------------------------
+
+	auto start = chrono::steady_clock::now();
+	Spline spline(SETTINGS_IS_LOOP);
+	spline.construct(controlPoints, SETTINGS_SPLINE_EPS, SETTINGS_IS_LOOP, threads);
+	SplineFrames frames(spline);
+	const RailsGeometry rails = RailsGeometry::build(frames, SETTINGS_RAILS_TRACK_WIDTH, SETTINGS_RAILS_WIDTH);
+	const std::vector<SplineFrame> ties = getTieFrames(frames, static_cast<size_t>(SETTINGS_TIES_COUNT));
+	printf("track: %zu points, %.2f units, %zu rail triangles, %zu ties in %.3f ms\n", spline.getPoints().size(),
+	       spline.distance(), rails.indices.size() / 3, ties.size(), getSeconds(start) * 1000.0);
+
+	//-----------------------------------------------------------------------------
+	// Simulating trains
+	//-----------------------------------------------------------------------------
+
+	TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+	const uint32_t track = fleet.addTrack(frames);
+	fleet.reserve(trains * SETTINGS_CARS_COUNT);
+	for (size_t i = 0; i < trains; i++) {
+		// heads spread evenly over the track, cars trail their head by the coupling
+		const float head = spline.distance() * static_cast<float>(i) / static_cast<float>(trains);
+		for (size_t car = 0; car < SETTINGS_CARS_COUNT; car++) {
+			fleet.addCar(track, head, SETTINGS_TRAIN_SPEED, SETTINGS_CARS_COUPLING * static_cast<float>(car));
+		}
+	}
+	fleet.setFixedPoint(isFixedPoint);
+
+	JobSystem jobs(threads);
+	Lockstep lockstep(fleet, SETTINGS_FIXED_TIMESTEP);
+	start = chrono::steady_clock::now();
+	lockstep.run(ticks, &jobs);
+	const double seconds = getSeconds(start);
+
+	const double carTicks = static_cast<double>(fleet.size()) * static_cast<double>(ticks);
+	printf("simulation: %zu cars, %zu ticks, %zu threads%s in %.3f s\n", fleet.size(), ticks, jobs.getThreadCount(),
+	       isFixedPoint ? ", fixed point" : "", seconds);
+	printf("throughput: %.0f ticks/s, %.0f cars*ticks/s, %.1f ns per car and tick\n", static_cast<double>(ticks) / seconds,
+	       carTicks / seconds, seconds * 1e9 / carTicks);
+	printf("state hash: %016llx\n", static_cast<unsigned long long>(lockstep.getHash()));
+	return 0;
+}
@@ -4,7 +4,9 @@
 #include "solution/spline.h"
 #include "solution/rails_drawer.h"
 #include "solution/utility.h"
-#include "solution/train.h"
+#include "solution/consist.h"
+#include "solution/spline_grid.h"
+#include "solution/track_streamer.h"
 
 using namespace std;
 using namespace glm;
@@ -14,16 +16,35 @@ using namespace glm;
 //-----------------------------------------------------------------------------
 
 #define SETTINGS_SPLINE_EPS		    0.01f
-#define SETTINGS_APPROX_EPS		    0.001f
+#define SETTINGS_SPLINE_TOLERANCE   0.005f
 #define SETTINGS_TIES_COUNT			std::pow(2, 7)
 #define SETTINGS_TIES_WIDTH			1.0f
 #define SETTINGS_RAILS_WIDTH		1.3f
 #define SETTINGS_RAILS_TRACK_WIDTH  0.2f
-#define SETTINGS_TRAIN_SPEED        0.02f
+#define SETTINGS_TRAIN_SPEED        1.2f
+#define SETTINGS_TRAIN_ACCELERATION 0.4f
+#define SETTINGS_TRAIN_BRAKING      0.8f
 #define SETTINGS_CARS_COUNT         4
+#define SETTINGS_CARS_COUPLING      1.4f
 
 #define SETTINGS_IS_LOOP true
 
+//#define SETTINGS_SPLINE_ADAPTIVE
+
+// simulation step in seconds, comment out to step once per rendered frame
+#define SETTINGS_FIXED_TIMESTEP     (1.0f / 60.0f)
+
+// arc length of the chunks rails and ties are merged into, comment out to draw them separately
+#define SETTINGS_STATIC_CHUNK_LENGTH 8.0f
+
+// build the chunks in the background only within this arc length of the camera and the train, evict them
+// least recently used first over the budget in bytes and upload for at most the slice in seconds per frame,
+// uncomment for tracks too long to build up front, the demo loop is built whole since a radius this small
+// leaves track the camera sees undrawn
+//#define SETTINGS_STREAMING_RADIUS    12.0f
+#define SETTINGS_STREAMING_BUDGET    (4 * 1024 * 1024)
+#define SETTINGS_STREAMING_SLICE     0.002f
+
 #define SETTINGS_WIREFRAME
 #define SETTINGS_SHOW_DEBUG_INFO
 
@@ -88,14 +109,21 @@ int main() {
 	// Converting points and constructing spline
 	//-----------------------------------------------------------------------------
 
-	Spline spline([&path]() {
+	const std::vector<vec3> controlPoints = [&path]() {
 		std::vector<vec3> result;
 		result.reserve(8);
 		for (int i = 0; i < 8; i++) {
 			result.emplace_back(path[i * 3], path[i * 3 + 1], path[i * 3 + 2]);
 		}
 		return result;
-	}(), SETTINGS_SPLINE_EPS, SETTINGS_IS_LOOP);
+	}();
+
+#ifdef SETTINGS_SPLINE_ADAPTIVE
+	Spline spline(SETTINGS_IS_LOOP);
+	spline.constructAdaptive(controlPoints, SETTINGS_SPLINE_TOLERANCE, SETTINGS_IS_LOOP);
+#else
+	Spline spline(controlPoints, SETTINGS_SPLINE_EPS, SETTINGS_IS_LOOP);
+#endif
 
 	//-----------------------------------------------------------------------------
 	// Drawing spline debug info
@@ -123,12 +151,11 @@ int main() {
 #endif
 
 	//-----------------------------------------------------------------------------
-	// Approximating spline and drawing it again if necessary
+	// Resampling spline evenly and drawing it again if necessary
 	//-----------------------------------------------------------------------------
 
-	Spline approxSpline = Spline::approx(spline, SETTINGS_TIES_COUNT, SETTINGS_APPROX_EPS);
-
 #ifdef SETTINGS_SHOW_DEBUG_INFO
+	Spline approxSpline = Spline::resample(spline, SETTINGS_TIES_COUNT);
 	splineDebugInfoFunc(approxSpline, 1.0f, 0.1f, vec3(1.0f, 1.0f, 0.0f));
 #endif
 
@@ -136,11 +163,21 @@ int main() {
 	// Drawing railroad
 	//-----------------------------------------------------------------------------
 
-	generateTies(approxSpline.toVector(), SETTINGS_TIES_WIDTH);
-
-	std::vector<vec3> splinePath = spline.toVector();
-	RailsDrawer railsDrawer(splinePath, SETTINGS_IS_LOOP,
-	                        SETTINGS_RAILS_TRACK_WIDTH, SETTINGS_RAILS_WIDTH);
+	// rails, ties and cars share one table of rotation-minimizing frames
+	SplineFrames frames(spline);
+#if defined(SETTINGS_STATIC_CHUNK_LENGTH) && defined(SETTINGS_STREAMING_RADIUS)
+	const SplineGrid grid(spline);
+	TrackStreamer streamer(frames, SETTINGS_STATIC_CHUNK_LENGTH, spline.distance() / SETTINGS_TIES_COUNT,
+	                       SETTINGS_TIES_WIDTH, SETTINGS_RAILS_TRACK_WIDTH, SETTINGS_RAILS_WIDTH,
+	                       SETTINGS_STREAMING_RADIUS, SETTINGS_STREAMING_BUDGET, SETTINGS_STREAMING_SLICE);
+#elif defined(SETTINGS_STATIC_CHUNK_LENGTH)
+	generateStaticTrack(frames, static_cast<std::size_t>(SETTINGS_TIES_COUNT), SETTINGS_TIES_WIDTH,
+	                    SETTINGS_RAILS_TRACK_WIDTH, SETTINGS_RAILS_WIDTH, SETTINGS_STATIC_CHUNK_LENGTH);
+#else
+	generateTies(frames, static_cast<std::size_t>(SETTINGS_TIES_COUNT), SETTINGS_TIES_WIDTH);
+
+	RailsDrawer railsDrawer(frames, SETTINGS_RAILS_TRACK_WIDTH, SETTINGS_RAILS_WIDTH);
+#endif
 
 	//-----------------------------------------------------------------------------
 	// Drawing train
@@ -155,12 +192,14 @@ int main() {
 		return train;
 	};
 
-	std::vector<Train> train;
-	train.reserve(SETTINGS_CARS_COUNT);
-	for (int i = 0; i < SETTINGS_CARS_COUNT; i++) {
-		train.emplace_back(cube_mesh, splinePath.front() + vec3 { 1.4f * i, 0.0f, 0.0f },
-		                   SETTINGS_TRAIN_SPEED);
-	}
+	// the last car starts at the beginning of the track
+	Consist train(cube_mesh, SETTINGS_CARS_COUNT, SETTINGS_CARS_COUPLING,
+	              SETTINGS_CARS_COUPLING * (SETTINGS_CARS_COUNT - 1), SETTINGS_TRAIN_SPEED,
+	              SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+
+#ifdef SETTINGS_FIXED_TIMESTEP
+	FixedTimestep timestep(SETTINGS_FIXED_TIMESTEP);
+#endif
 
 	//-----------------------------------------------------------------------------
 
@@ -171,15 +210,32 @@ int main() {
 	// main loop
 	while (!engine->isDone()) {
 		engine->update();
+
+#if defined(SETTINGS_STATIC_CHUNK_LENGTH) && defined(SETTINGS_STREAMING_RADIUS)
+		// the track around the train and around its point closest to the camera
+		std::vector<float> focus = { train.getLocomotive().getDistance() };
+		SplineHit hit;
+		if (grid.nearest(cam.Position, hit)) {
+			focus.push_back(hit.distance);
+		}
+		streamer.update(focus);
+#endif
+
 		engine->render();
 
-		// NOTE: Speed is frame rate dependent
 		//-----------------------------------------------------------------------------
+#ifndef SETTINGS_STATIC_CHUNK_LENGTH
 		railsDrawer.draw();
+#endif
 
-		for (auto & car : train) {
-			car.tutuuu(splinePath);
+#ifdef SETTINGS_FIXED_TIMESTEP
+		for (std::size_t steps = timestep.advance(engine->getDeltaTime()); steps > 0; steps--) {
+			train.step(spline, timestep.getStep());
 		}
+		train.render(frames, timestep.getAlpha());
+#else
+		train.tutuuu(frames, engine->getDeltaTime());
+#endif
 
 		//-----------------------------------------------------------------------------
 
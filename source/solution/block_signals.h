@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "train_fleet.h"
+
+// fixed block signalling on one track: the track is split into blocks of equal arc length, a train may only
+// run into blocks it holds and every block is held by at most one train, the block of an arc length is found
+// by a division and a train's work per tick grows only with the blocks its tail crossed and with its cars
+class BlockSignals {
+public:
+	BlockSignals(const Spline & spline, const float blockLength)
+		: m_spline(&spline), m_blockLength(blockLength), m_count(0) {
+		m_count = glm::max<std::size_t>(static_cast<std::size_t>(glm::ceil(spline.distance() / blockLength)), 1);
+		m_owners.reset(new std::atomic<std::uint32_t>[m_count]);
+		for (std::size_t i = 0; i < m_count; i++) {
+			m_owners[i].store(Free, std::memory_order_relaxed);
+		}
+	}
+
+public:
+	// cars [first, first + count) of the fleet share one head and form a train of the given length behind it,
+	// the train takes the blocks under it, false and nothing taken if another train holds one of them
+	bool addTrain(const TrainFleet & fleet, const std::size_t first, const std::size_t count, const float length) {
+		const auto id = static_cast<std::uint32_t>(m_trains.size());
+		const float head = m_spline->wrap(fleet.getDistances()[first]);
+		const Train train = { first, count, length, getBlock(head - length), getBlock(head) };
+
+		for (std::size_t block = train.tail;; block = next(block)) {
+			std::uint32_t owner = Free;
+			if (!m_owners[block].compare_exchange_strong(owner, id, std::memory_order_acq_rel)) {
+				// give back what this call already took
+				for (std::size_t taken = train.tail; taken != block; taken = next(taken)) {
+					m_owners[taken].store(Free, std::memory_order_release);
+				}
+				return false;
+			}
+			if (block == train.reserved) {
+				break;
+			}
+		}
+		m_trains.push_back(train);
+		return true;
+	}
+
+	void update(TrainFleet & fleet) {
+		update(fleet, 0, m_trains.size());
+	}
+
+	// trains [first, last) release the blocks their tails left and request the next block once they could
+	// no longer stop in front of it, then every car gets the authority up to the end of the held blocks,
+	// disjoint ranges may run concurrently
+	void update(TrainFleet & fleet, const std::size_t first, const std::size_t last) {
+		const std::vector<float> & distances = fleet.getDistances();
+		const std::vector<float> & velocities = fleet.getVelocities();
+		const float braking = fleet.getBraking();
+		for (std::size_t i = first; i < last; i++) {
+			Train & train = m_trains[i];
+			const auto id = static_cast<std::uint32_t>(i);
+			const float head = m_spline->wrap(distances[train.first]);
+
+			// the tail moves at most one block per tick unless blocks are shorter than a tick of travel
+			const std::size_t tail = getBlock(head - train.length);
+			while (train.tail != tail && train.tail != train.reserved) {
+				m_owners[train.tail].store(Free, std::memory_order_release);
+				train.tail = next(train.tail);
+			}
+
+			float authority = getAuthority(train, head);
+			const float velocity = velocities[train.first];
+			const std::size_t ahead = next(train.reserved);
+			if (authority < velocity * velocity / (2.0f * braking) + m_blockLength && ahead != train.tail &&
+			    ahead != train.reserved) {
+				std::uint32_t owner = Free;
+				if (m_owners[ahead].compare_exchange_strong(owner, id, std::memory_order_acq_rel)) {
+					train.reserved = ahead;
+					authority = getAuthority(train, head);
+				}
+			}
+
+			for (std::size_t car = train.first; car < train.first + train.count; car++) {
+				fleet.setAuthority(car, authority);
+			}
+		}
+	}
+
+public:
+	// block an arc length falls into, wrapped for loops and clamped otherwise
+	std::size_t getBlock(const float distance) const {
+		const auto block = static_cast<std::size_t>(m_spline->wrap(distance) / m_blockLength);
+		return glm::min(block, m_count - 1);
+	}
+
+	bool isOccupied(const std::size_t block) const {
+		return m_owners[block].load(std::memory_order_acquire) != Free;
+	}
+
+	// id of the train holding the block, getTrainCount() if none
+	std::size_t getOwner(const std::size_t block) const {
+		const std::uint32_t owner = m_owners[block].load(std::memory_order_acquire);
+		return owner == Free ? m_trains.size() : owner;
+	}
+
+	std::size_t getBlockCount() const {
+		return m_count;
+	}
+
+	float getBlockLength() const {
+		return m_blockLength;
+	}
+
+	std::size_t getTrainCount() const {
+		return m_trains.size();
+	}
+
+private:
+	struct Train {
+		std::size_t first;
+		std::size_t count;
+		float length;
+		// held blocks run from the one under the tail to the furthest one reserved ahead
+		std::size_t tail;
+		std::size_t reserved;
+	};
+
+	// arc length from the head to the end of the furthest held block
+	float getAuthority(const Train & train, const float head) const {
+		const float total = m_spline->distance();
+		const float end = glm::min(static_cast<float>(train.reserved + 1) * m_blockLength, total);
+		// on a loop the end is the closer of its two images, a train never holds half of the loop ahead of it,
+		// and a train stopped at the end of its blocks may overshoot it by rounding and has no authority left
+		float result = end - head;
+		if (m_spline->isLoop()) {
+			if (result < -0.5f * total) {
+				result += total;
+			} else if (result > 0.5f * total) {
+				result -= total;
+			}
+		}
+		if (!m_spline->isLoop() && train.reserved + 1 == m_count) {
+			// the end of an open track is a buffer stop the fleet already brakes for
+			return std::numeric_limits<float>::max();
+		}
+		return glm::max(result, 0.0f);
+	}
+
+	std::size_t next(const std::size_t block) const {
+		if (block + 1 < m_count) {
+			return block + 1;
+		}
+		return m_spline->isLoop() ? 0 : block;
+	}
+
+private:
+	static constexpr std::uint32_t Free = 0xffffffff;
+
+	const Spline * m_spline;
+	float m_blockLength;
+	std::size_t m_count;
+
+private:
+	std::unique_ptr<std::atomic<std::uint32_t>[]> m_owners;
+	std::vector<Train> m_trains;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "glm/vec3.hpp"
+
+// define CATMULL_ROM_SCALAR to force the scalar path
+#if !defined(CATMULL_ROM_SCALAR)
+#if defined(__AVX__)
+#define CATMULL_ROM_AVX
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CATMULL_ROM_SSE
+#include <xmmintrin.h>
+#endif
+#endif
+
+// Catmull-Rom segment between p2 and p3 as a cubic a * t^3 + b * t^2 + c * t + d, same curve as glm::catmullRom
+class CatmullRom {
+public:
+	CatmullRom(const glm::vec3 & p1, const glm::vec3 & p2, const glm::vec3 & p3, const glm::vec3 & p4)
+		: m_a(.5f * (-p1 + 3.0f * p2 - 3.0f * p3 + p4)),
+		  m_b(.5f * (2.0f * p1 - 5.0f * p2 + 4.0f * p3 - p4)),
+		  m_c(.5f * (p3 - p1)),
+		  m_d(p2) {}
+
+public:
+	glm::vec3 get(const float t) const {
+		return ((m_a * t + m_b) * t + m_c) * t + m_d;
+	}
+
+	glm::vec3 getDerivative(const float t) const {
+		return (3.0f * m_a * t + 2.0f * m_b) * t + m_c;
+	}
+
+	glm::vec3 getSecondDerivative(const float t) const {
+		return 6.0f * m_a * t + 2.0f * m_b;
+	}
+
+	// writes the points at t = i * step for i in [0, n) into x, y and z
+	void evaluate(const std::size_t n, const float step, float * x, float * y, float * z) const {
+		std::size_t i = 0;
+#if defined(CATMULL_ROM_AVX)
+		const __m256 lanes = _mm256_setr_ps(.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+		for (; i + 8 <= n; i += 8) {
+			const __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lanes),
+			                               _mm256_set1_ps(step));
+			_mm256_storeu_ps(x + i, horner(t, m_a.x, m_b.x, m_c.x, m_d.x));
+			_mm256_storeu_ps(y + i, horner(t, m_a.y, m_b.y, m_c.y, m_d.y));
+			_mm256_storeu_ps(z + i, horner(t, m_a.z, m_b.z, m_c.z, m_d.z));
+		}
+#elif defined(CATMULL_ROM_SSE)
+		const __m128 lanes = _mm_setr_ps(.0f, 1.0f, 2.0f, 3.0f);
+		for (; i + 4 <= n; i += 4) {
+			const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lanes), _mm_set1_ps(step));
+			_mm_storeu_ps(x + i, horner(t, m_a.x, m_b.x, m_c.x, m_d.x));
+			_mm_storeu_ps(y + i, horner(t, m_a.y, m_b.y, m_c.y, m_d.y));
+			_mm_storeu_ps(z + i, horner(t, m_a.z, m_b.z, m_c.z, m_d.z));
+		}
+#endif
+		for (; i < n; i++) {
+			const glm::vec3 point = get(static_cast<float>(i) * step);
+			x[i] = point.x;
+			y[i] = point.y;
+			z[i] = point.z;
+		}
+	}
+
+private:
+#if defined(CATMULL_ROM_AVX)
+	static __m256 horner(const __m256 t, const float a, const float b, const float c, const float d) {
+		__m256 result = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a), t), _mm256_set1_ps(b));
+		result = _mm256_add_ps(_mm256_mul_ps(result, t), _mm256_set1_ps(c));
+		return _mm256_add_ps(_mm256_mul_ps(result, t), _mm256_set1_ps(d));
+	}
+#elif defined(CATMULL_ROM_SSE)
+	static __m128 horner(const __m128 t, const float a, const float b, const float c, const float d) {
+		__m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a), t), _mm_set1_ps(b));
+		result = _mm_add_ps(_mm_mul_ps(result, t), _mm_set1_ps(c));
+		return _mm_add_ps(_mm_mul_ps(result, t), _mm_set1_ps(d));
+	}
+#endif
+
+private:
+	glm::vec3 m_a;
+	glm::vec3 m_b;
+	glm::vec3 m_c;
+	glm::vec3 m_d;
+};
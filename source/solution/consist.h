@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+
+#include "train.h"
+
+// locomotive followed by cars at fixed coupler distances along the arc length, only the locomotive is simulated
+class Consist {
+public:
+	Consist(Mesh & mesh, const std::size_t count, const float coupling = 1.4f, const float distance = 0.0f,
+	        const float speed = 1.0f, const float acceleration = 0.5f, const float braking = 1.0f)
+		: m_locomotive(mesh, distance, speed, acceleration, braking), m_coupling(coupling) {
+		const std::size_t cars = count > 0 ? count - 1 : 0;
+		m_cars.reserve(cars);
+		for (std::size_t i = 0; i < cars; i++) {
+			Object * car = Engine::get()->createObject(&mesh);
+			car->setColor(0.2f, 0.0f, 0.0f);
+			car->setScale(0.5f, 0.5f, 1.0f);
+			m_cars.push_back(car);
+		}
+		m_distances.resize(size());
+		m_frames.resize(size());
+	}
+
+public:
+	void tutuuu(const SplineFrames & frames, const float dt) {
+		step(frames.getSpline(), dt);
+		render(frames);
+	}
+
+	void step(const Spline & spline, const float dt) {
+		m_locomotive.step(spline, dt);
+	}
+
+	// places every car with one batch of sorted arc-length lookups, alpha as in Train::render
+	void render(const SplineFrames & frames, const float alpha = 1.0f) {
+		// the last car comes first so that the distances ascend
+		const float head = m_locomotive.getDistance(alpha);
+		const std::size_t n = size();
+		for (std::size_t i = 0; i < n; i++) {
+			m_distances[i] = head - m_coupling * static_cast<float>(n - 1 - i);
+		}
+		frames.get(m_distances.data(), n, m_frames.data());
+
+		for (std::size_t i = 0; i < n; i++) {
+			Object * object = i + 1 < n ? m_cars[n - 2 - i] : m_locomotive.getObject();
+			object->setPosition(m_frames[i].position);
+			object->setRotation(m_frames[i].getRotation());
+		}
+	}
+
+public:
+	Train & getLocomotive() {
+		return m_locomotive;
+	}
+
+	const Train & getLocomotive() const {
+		return m_locomotive;
+	}
+
+	// cars behind the locomotive, the first one is coupled to it
+	const std::vector<Object *> & getCars() const {
+		return m_cars;
+	}
+
+	float getCoupling() const {
+		return m_coupling;
+	}
+
+	// number of vehicles including the locomotive
+	std::size_t size() const noexcept {
+		return m_cars.size() + 1;
+	}
+
+private:
+	Train m_locomotive;
+	std::vector<Object *> m_cars;
+	float m_coupling;
+
+private:
+	// scratch buffers of the batched lookup
+	std::vector<float> m_distances;
+	std::vector<SplineFrame> m_frames;
+};
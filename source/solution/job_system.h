@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "glm/common.hpp"
+
+// fixed pool of workers with one deque each, owners take jobs from the back and idle workers steal from the front
+class JobSystem {
+public:
+	using Job = std::function<void()>;
+
+	// threads counts the calling thread as well, 0 uses every hardware thread
+	explicit JobSystem(std::size_t threads = 0) : m_queued(0), m_isDone(false), m_next(0) {
+		if (threads == 0) {
+			threads = glm::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+		}
+		// queue 0 belongs to the thread that submits work
+		for (std::size_t i = 0; i < threads; i++) {
+			m_queues.emplace_back(new Queue());
+		}
+		m_workers.reserve(threads - 1);
+		for (std::size_t i = 1; i < threads; i++) {
+			m_workers.emplace_back([this, i]() {
+				work(i);
+			});
+		}
+	}
+
+	~JobSystem() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isDone = true;
+		}
+		m_wake.notify_all();
+		for (auto & worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	JobSystem(const JobSystem &) = delete;
+	JobSystem & operator=(const JobSystem &) = delete;
+
+public:
+	// calls function(first, last) over [0, n) in chunks of at most grain and returns when every chunk is done,
+	// the calling thread works on chunks too
+	template <typename Function>
+	void parallelFor(const std::size_t n, std::size_t grain, Function function) {
+		grain = glm::max<std::size_t>(grain, 1);
+		const std::size_t chunks = (n + grain - 1) / grain;
+		if (chunks <= 1 || m_workers.empty()) {
+			if (n > 0) {
+				function(std::size_t(0), n);
+			}
+			return;
+		}
+
+		std::atomic<std::size_t> remaining(chunks);
+		for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+			const std::size_t first = chunk * grain;
+			const std::size_t last = glm::min(first + grain, n);
+			push([&function, &remaining, first, last]() {
+				function(first, last);
+				remaining.fetch_sub(1, std::memory_order_release);
+			});
+		}
+		{
+			// a worker that just found nothing is either asleep by now or sees the new jobs
+			std::lock_guard<std::mutex> lock(m_mutex);
+		}
+		m_wake.notify_all();
+
+		Job job;
+		while (remaining.load(std::memory_order_acquire) > 0) {
+			if (take(0, job)) {
+				job();
+			} else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+public:
+	std::size_t getThreadCount() const {
+		return m_queues.size();
+	}
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	// spreads jobs over the queues round robin so that every worker starts with its own share
+	void push(Job job) {
+		Queue & queue = *m_queues[m_next++ % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		// counted before the job is visible, so a take can never decrement ahead of this and wrap the count
+		m_queued.fetch_add(1, std::memory_order_release);
+		queue.jobs.push_back(std::move(job));
+	}
+
+	// the back of the own queue first, then the front of the others starting from the next one
+	bool take(const std::size_t idx, Job & job) {
+		for (std::size_t i = 0; i < m_queues.size(); i++) {
+			Queue & queue = *m_queues[(idx + i) % m_queues.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty()) {
+				continue;
+			}
+			if (i == 0) {
+				job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+			} else {
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+			}
+			m_queued.fetch_sub(1, std::memory_order_acquire);
+			return true;
+		}
+		return false;
+	}
+
+	// a worker that runs dry polls a few more times, jobs of one parallelFor tend to arrive in a burst, then sleeps
+	void work(const std::size_t idx) {
+		Job job;
+		int spins = 0;
+		while (true) {
+			if (take(idx, job)) {
+				job();
+				spins = 0;
+				continue;
+			}
+			if (spins < maxSpins) {
+				spins++;
+				std::this_thread::yield();
+				continue;
+			}
+			spins = 0;
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this]() {
+				return m_isDone || m_queued.load(std::memory_order_acquire) > 0;
+			});
+			if (m_isDone) {
+				return;
+			}
+		}
+	}
+
+private:
+	std::vector<std::unique_ptr<Queue>> m_queues;
+	std::vector<std::thread> m_workers;
+
+private:
+	static constexpr int maxSpins = 64;
+
+	// jobs waiting in any queue, only changed under the lock of the queue that holds the job so it never falls
+	// below zero, idle workers sleep while it is zero
+	std::atomic<std::size_t> m_queued;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_isDone;
+	std::atomic<std::size_t> m_next;
+};
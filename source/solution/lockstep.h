@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "train_fleet.h"
+
+// advances a fleet in whole ticks of a fixed step, independent of the wall clock, and records a hash chain
+// of its state: the hash of a tick covers every tick before it, so two runs agree up to their first divergence
+class Lockstep {
+public:
+	explicit Lockstep(TrainFleet & fleet, const float step = 1.0f / 60.0f)
+		: m_fleet(&fleet), m_step(step) {}
+
+public:
+	// cars are updated in index order, with a job system every car is still updated from its own state only
+	std::uint64_t tick(JobSystem * jobs = nullptr) {
+		if (jobs) {
+			m_fleet->update(m_step, *jobs);
+		} else {
+			m_fleet->update(m_step);
+		}
+		const std::uint64_t previous = m_hashes.empty() ? 0 : m_hashes.back();
+		m_hashes.push_back((previous ^ m_fleet->getStateHash()) * 1099511628211ull + m_hashes.size());
+		return m_hashes.back();
+	}
+
+	void run(const std::size_t ticks, JobSystem * jobs = nullptr) {
+		m_hashes.reserve(m_hashes.size() + ticks);
+		for (std::size_t i = 0; i < ticks; i++) {
+			tick(jobs);
+		}
+	}
+
+	// first tick whose hashes differ, found by bisection, the shorter length if one run is a prefix of the other
+	static std::size_t findDivergence(const std::vector<std::uint64_t> & a, const std::vector<std::uint64_t> & b) {
+		std::size_t first = 0;
+		std::size_t last = std::min(a.size(), b.size());
+		while (first < last) {
+			const std::size_t middle = first + (last - first) / 2;
+			if (a[middle] == b[middle]) {
+				first = middle + 1;
+			} else {
+				last = middle;
+			}
+		}
+		return first;
+	}
+
+public:
+	// number of ticks run so far
+	std::size_t getTick() const {
+		return m_hashes.size();
+	}
+
+	std::uint64_t getHash() const {
+		return m_hashes.empty() ? 0 : m_hashes.back();
+	}
+
+	// hash after every tick, the i-th one after tick i + 1
+	const std::vector<std::uint64_t> & getHashes() const {
+		return m_hashes;
+	}
+
+	float getStep() const {
+		return m_step;
+	}
+
+private:
+	TrainFleet * m_fleet;
+	float m_step;
+	std::vector<std::uint64_t> m_hashes;
+};
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "framework/engine.h"
+#include "track_geometry.h"
 
 class RailsDrawer
 {
@@ -18,6 +19,21 @@ public:
       , m_color(color)
     {
         setPoints(points, loop, trackWidth, railWidth);
+        resolveUniforms();
+    }
+
+    explicit RailsDrawer(
+        const SplineFrames & frames,
+        const float          trackWidth = 0.2f,
+        const float          railWidth  = 1.4f,
+        const glm::vec3 &    color      = { 0.15f, 0.15f, 0.15f }
+    )
+        : m_leftRail(Mesh())
+      , m_rightRail(Mesh())
+      , m_color(color)
+    {
+        setPoints(frames, trackWidth, railWidth);
+        resolveUniforms();
     }
 
     void setPoints(
@@ -27,46 +43,24 @@ public:
         const float                    railWidth  = 1.4f
     )
     {
-        std::vector<Vertex>       leftVertices;
-        std::vector<Vertex>       rightVertices;
-        std::vector<unsigned int> indices;
-        for (std::size_t i = 0; i < points.size() - 1; i++)
+        std::vector<glm::vec3> forwards;
+        for (std::size_t i = 0; i + 1 < points.size(); i++)
         {
-            const glm::vec3 forward = normalize((points[i + 1] - points[i]));
-            const glm::vec3 up      = { 0.0f, 1.0f, 0.0f };
-            const glm::vec3 right   = cross(forward, up);
-
-            leftVertices.push_back({ points[i] - right * trackWidth * railWidth, up, glm::vec2(0.0f) });
-            leftVertices.push_back({ points[i] - right * trackWidth, up, glm::vec2(0.0f) });
-
-            rightVertices.push_back({ points[i] + right * trackWidth, up, glm::vec2(0.0f) });
-            rightVertices.push_back({ points[i] + right * trackWidth * railWidth, up, glm::vec2(0.0f) });
-        }
-
-        for (unsigned int i = 0; i < points.size() * 2 - 4; i += 2)
-        {
-            indices.push_back(i);
-            indices.push_back(i + 1);
-            indices.push_back(i + 2);
-
-            indices.push_back(i + 1);
-            indices.push_back(i + 3);
-            indices.push_back(i + 2);
-        }
-
-        if (!indices.empty() && loop)
-        {
-            indices.push_back(static_cast<unsigned int>(leftVertices.size() - 2));
-            indices.push_back(static_cast<unsigned int>(leftVertices.size() - 1));
-            indices.push_back(0);
-
-            indices.push_back(static_cast<unsigned int>(leftVertices.size() - 1));
-            indices.push_back(1);
-            indices.push_back(0);
+            forwards.push_back(normalize(points[i + 1] - points[i]));
         }
+        build(points, forwards, std::vector<glm::vec3>(forwards.size(), { 0.0f, 1.0f, 0.0f }), loop, trackWidth,
+              railWidth);
+    }
 
-        m_leftRail.set(leftVertices, indices);
-        m_rightRail.set(rightVertices, indices);
+    // rails follow the rotation-minimizing frames of the track, so they bank and climb with it
+    void setPoints(
+        const SplineFrames & frames,
+        const float          trackWidth = 0.2f,
+        const float          railWidth  = 1.4f
+    )
+    {
+        const std::vector<glm::vec3> points = frames.getSpline().toVector();
+        build(points, frames.getTangents(), frames.getUps(), frames.getSpline().isLoop(), trackWidth, railWidth);
     }
 
     void setColor(const glm::vec3 & color)
@@ -86,17 +80,54 @@ public:
 
     void draw()
     {
-        Engine * engine = Engine::get();
+        const Shader & shader = Engine::get()->getShader();
 
-        engine->getShader().setMat4("model", glm::mat4(1.0f));
-        engine->getShader().setVec3("albedo", m_color);
+        shader.set(m_modelUniform, glm::mat4(1.0f));
+        shader.set(m_albedoUniform, m_color);
 
         m_leftRail.draw(GL_TRIANGLES);
         m_rightRail.draw(GL_TRIANGLES);
     }
 
+private:
+    // looks up the uniforms draw sets once instead of on every draw
+    void resolveUniforms()
+    {
+        const Shader & shader = Engine::get()->getShader();
+
+        m_modelUniform  = shader.getUniform<glm::mat4>("model");
+        m_albedoUniform = shader.getUniform<glm::vec3>("albedo");
+    }
+
+    // forwards and ups hold the basis of the track at least at every point but the last one
+    void build(
+        const std::vector<glm::vec3> & points,
+        const std::vector<glm::vec3> & forwards,
+        const std::vector<glm::vec3> & ups,
+        const bool                     loop,
+        const float                    trackWidth,
+        const float                    railWidth
+    )
+    {
+        const RailsGeometry geometry = RailsGeometry::build(points, forwards, ups, loop, trackWidth, railWidth);
+
+        std::vector<Vertex> leftVertices;
+        std::vector<Vertex> rightVertices;
+        for (std::size_t i = 0; i < geometry.normals.size(); i++)
+        {
+            leftVertices.push_back({ geometry.left[i], geometry.normals[i], glm::vec2(0.0f) });
+            rightVertices.push_back({ geometry.right[i], geometry.normals[i], glm::vec2(0.0f) });
+        }
+
+        m_leftRail.set(leftVertices, geometry.indices);
+        m_rightRail.set(rightVertices, geometry.indices);
+    }
+
 private:
     Mesh      m_leftRail;
     Mesh      m_rightRail;
     glm::vec3 m_color;
+
+    Uniform<glm::mat4> m_modelUniform;
+    Uniform<glm::vec3> m_albedoUniform;
 };
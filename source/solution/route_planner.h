@@ -0,0 +1,373 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "track_graph.h"
+
+// edges a train takes from one node to another and their total arc length
+struct Route {
+	std::vector<std::uint32_t> edges;
+	float length;
+
+	bool empty() const {
+		return edges.empty();
+	}
+};
+
+// shortest routes between nodes of a track graph by A* over edges weighted by their arc length, recent results
+// are kept in a least recently used cache keyed by the nodes and the switch epoch of the graph
+//
+// the search is bounded by landmarks: the arc lengths from and to a few edges far apart are computed once per
+// network, and by the triangle inequality they bound what is left of a route much tighter than the straight
+// line to the target does
+class RoutePlanner {
+public:
+	explicit RoutePlanner(const TrackGraph & graph, const std::size_t cacheSize = 1024,
+	                      const std::size_t landmarks = 8)
+		: m_graph(&graph), m_cacheSize(cacheSize), m_landmarkCount(landmarks), m_revision(graph.getRevision() + 1),
+		  m_hits(0), m_misses(0), m_stamp(0) {}
+
+	RoutePlanner(const RoutePlanner &) = delete;
+	RoutePlanner & operator=(const RoutePlanner &) = delete;
+
+public:
+	// the route may take any option at a junction, it is empty if to cannot be reached or from equals to,
+	// the reference is valid until the next call
+	const Route & find(const std::uint32_t from, const std::uint32_t to) {
+		if (m_revision != m_graph->getRevision()) {
+			prepare();
+		}
+
+		// routes of older epochs are never hit again and age out of the cache
+		const Key key = { from, to, m_graph->getEpoch() };
+		const auto it = m_entries.find(key);
+		if (it != m_entries.end()) {
+			m_hits++;
+			m_order.splice(m_order.begin(), m_order, it->second);
+			return it->second->second;
+		}
+		m_misses++;
+
+		if (m_cacheSize == 0) {
+			m_uncached = search(from, to);
+			return m_uncached;
+		}
+		if (m_entries.size() >= m_cacheSize) {
+			m_entries.erase(m_order.back().first);
+			m_order.pop_back();
+		}
+		m_order.emplace_front(key, search(from, to));
+		m_entries[key] = m_order.begin();
+		return m_order.front().second;
+	}
+
+	void clear() {
+		m_entries.clear();
+		m_order.clear();
+	}
+
+public:
+	std::size_t getCacheSize() const {
+		return m_entries.size();
+	}
+
+	std::size_t getHits() const {
+		return m_hits;
+	}
+
+	std::size_t getMisses() const {
+		return m_misses;
+	}
+
+	// landmarks of the current network, fewer than asked for if it has fewer edges
+	std::size_t getLandmarkCount() const {
+		return m_landmarks.size();
+	}
+
+private:
+	struct Key {
+		std::uint32_t from;
+		std::uint32_t to;
+		std::uint64_t epoch;
+
+		bool operator==(const Key & other) const {
+			return from == other.from && to == other.to && epoch == other.epoch;
+		}
+	};
+
+	struct KeyHash {
+		std::size_t operator()(const Key & key) const {
+			const std::uint64_t nodes = (static_cast<std::uint64_t>(key.from) << 32) | key.to;
+			return std::hash<std::uint64_t>()(nodes ^ (key.epoch * 0x9e3779b97f4a7c15ull));
+		}
+	};
+
+	// open edge ordered by the arc length to its end plus the bound of what is left from there
+	struct Open {
+		float estimate;
+		float cost;
+		std::uint32_t edge;
+
+		bool operator>(const Open & other) const {
+			return estimate > other.estimate;
+		}
+	};
+
+	// edge weights, node positions, predecessors and landmark distances of the current network
+	void prepare() {
+		clear();
+		m_revision = m_graph->getRevision();
+		const std::size_t edges = m_graph->getEdgeCount();
+		const std::size_t nodes = m_graph->getNodeCount();
+		m_positions.assign(nodes, glm::vec3(.0f));
+		m_lengths.resize(edges);
+		m_ends.resize(edges);
+		for (std::uint32_t i = 0; i < edges; i++) {
+			const Spline & spline = m_graph->getSpline(i);
+			m_positions[m_graph->getFrom(i)] = spline.getAtDistance(.0f);
+			m_positions[m_graph->getTo(i)] = spline.getAtDistance(spline.distance());
+			m_lengths[i] = spline.distance();
+			m_ends[i] = m_graph->getTo(i);
+		}
+
+		// predecessors of every edge and the edges arriving at every node, laid out like the successor table
+		m_predecessorOffsets.assign(edges + 1, 0);
+		m_arrivingOffsets.assign(nodes + 1, 0);
+		for (std::uint32_t i = 0; i < edges; i++) {
+			for (std::uint32_t k = 0; k < m_graph->getOptionCount(i); k++) {
+				m_predecessorOffsets[m_graph->getOption(i, k) + 1]++;
+			}
+			m_arrivingOffsets[m_ends[i] + 1]++;
+		}
+		std::partial_sum(m_predecessorOffsets.begin(), m_predecessorOffsets.end(), m_predecessorOffsets.begin());
+		std::partial_sum(m_arrivingOffsets.begin(), m_arrivingOffsets.end(), m_arrivingOffsets.begin());
+		m_predecessors.resize(m_predecessorOffsets.back());
+		m_arriving.resize(edges);
+		std::vector<std::uint32_t> predecessors(m_predecessorOffsets.begin(), m_predecessorOffsets.end() - 1);
+		std::vector<std::uint32_t> arriving(m_arrivingOffsets.begin(), m_arrivingOffsets.end() - 1);
+		for (std::uint32_t i = 0; i < edges; i++) {
+			for (std::uint32_t k = 0; k < m_graph->getOptionCount(i); k++) {
+				m_predecessors[predecessors[m_graph->getOption(i, k)]++] = i;
+			}
+			m_arriving[arriving[m_ends[i]]++] = i;
+		}
+
+		m_costs.assign(edges, .0f);
+		m_parents.assign(edges, TrackGraph::None);
+		m_stamps.assign(edges, 0);
+		m_stamp = 0;
+		chooseLandmarks();
+	}
+
+	// every next landmark is the edge furthest from the ones chosen so far, starting with the edge furthest
+	// from edge 0, the arc lengths are stored per edge so that the search reads one block for all landmarks
+	void chooseLandmarks() {
+		const std::size_t edges = m_lengths.size();
+		const std::size_t count = glm::min(m_landmarkCount, edges);
+		const float unreachable = std::numeric_limits<float>::infinity();
+		m_landmarks.clear();
+		m_forward.assign(edges * count, unreachable);
+		m_backward.assign(edges * count, unreachable);
+		if (count == 0) {
+			return;
+		}
+
+		std::vector<float> lengths;
+		std::vector<float> nearest(edges, unreachable);
+		measure(0, true, lengths);
+		std::uint32_t landmark = getFurthest(lengths);
+		for (std::size_t l = 0; l < count; l++) {
+			m_landmarks.push_back(landmark);
+			measure(landmark, true, lengths);
+			for (std::size_t i = 0; i < edges; i++) {
+				m_forward[i * count + l] = lengths[i];
+				nearest[i] = glm::min(nearest[i], lengths[i]);
+			}
+			measure(landmark, false, lengths);
+			for (std::size_t i = 0; i < edges; i++) {
+				m_backward[i * count + l] = lengths[i];
+			}
+			landmark = getFurthest(nearest);
+		}
+	}
+
+	// Dijkstra from the end of an edge along the successors or to it along the predecessors, entering an edge
+	// costs its arc length, infinity where there is no way
+	void measure(const std::uint32_t source, const bool isForward, std::vector<float> & result) const {
+		result.assign(m_lengths.size(), std::numeric_limits<float>::infinity());
+		std::priority_queue<Open, std::vector<Open>, std::greater<Open>> open;
+		result[source] = .0f;
+		open.push({ .0f, .0f, source });
+		while (!open.empty()) {
+			const Open top = open.top();
+			open.pop();
+			if (top.cost > result[top.edge]) {
+				continue;
+			}
+			if (isForward) {
+				for (std::uint32_t k = 0; k < m_graph->getOptionCount(top.edge); k++) {
+					const std::uint32_t next = m_graph->getOption(top.edge, k);
+					const float cost = top.cost + m_lengths[next];
+					if (cost < result[next]) {
+						result[next] = cost;
+						open.push({ cost, cost, next });
+					}
+				}
+			} else {
+				const float cost = top.cost + m_lengths[top.edge];
+				for (std::uint32_t k = m_predecessorOffsets[top.edge]; k < m_predecessorOffsets[top.edge + 1]; k++) {
+					const std::uint32_t previous = m_predecessors[k];
+					if (cost < result[previous]) {
+						result[previous] = cost;
+						open.push({ cost, cost, previous });
+					}
+				}
+			}
+		}
+	}
+
+	static std::uint32_t getFurthest(const std::vector<float> & lengths) {
+		std::uint32_t result = 0;
+		float best = -1.0f;
+		for (std::size_t i = 0; i < lengths.size(); i++) {
+			if (isReachable(lengths[i]) && lengths[i] > best) {
+				best = lengths[i];
+				result = static_cast<std::uint32_t>(i);
+			}
+		}
+		return result;
+	}
+
+	static bool isReachable(const float length) {
+		return length < std::numeric_limits<float>::infinity();
+	}
+
+	// lower bound of the arc length from the end of an edge to the target, the terms of landmarks that do not
+	// reach either end bound nothing and are skipped
+	float estimate(const std::uint32_t edge, const glm::vec3 & target) const {
+		float result = glm::distance(m_positions[m_ends[edge]], target);
+		const std::size_t count = m_landmarks.size();
+		const float * forward = m_forward.data() + edge * count;
+		const float * backward = m_backward.data() + edge * count;
+		for (std::size_t l = 0; l < count; l++) {
+			if (isReachable(forward[l]) && isReachable(m_goalForward[l])) {
+				result = glm::max(result, m_goalForward[l] - forward[l]);
+			}
+			if (isReachable(backward[l]) && isReachable(m_goalBackward[l])) {
+				result = glm::max(result, backward[l] - m_goalBackward[l]);
+			}
+		}
+		return result;
+	}
+
+	// searches edges rather than nodes because the options after an edge depend on the edge, not only its node
+	Route search(const std::uint32_t from, const std::uint32_t to) {
+		Route route = { {}, .0f };
+		if (from == to || m_arrivingOffsets[to] == m_arrivingOffsets[to + 1]) {
+			return route;
+		}
+
+		// the goal is any edge arriving at the target, the landmarks bound the way to the closest one of them
+		const std::size_t count = m_landmarks.size();
+		m_goalForward.assign(count, std::numeric_limits<float>::infinity());
+		m_goalBackward.assign(count, .0f);
+		for (std::uint32_t k = m_arrivingOffsets[to]; k < m_arrivingOffsets[to + 1]; k++) {
+			for (std::size_t l = 0; l < count; l++) {
+				m_goalForward[l] = glm::min(m_goalForward[l], m_forward[m_arriving[k] * count + l]);
+				m_goalBackward[l] = glm::max(m_goalBackward[l], m_backward[m_arriving[k] * count + l]);
+			}
+		}
+
+		// stamps mark the costs written by this search, so nothing is cleared between searches
+		if (++m_stamp == 0) {
+			std::fill(m_stamps.begin(), m_stamps.end(), 0);
+			m_stamp = 1;
+		}
+		std::priority_queue<Open, std::vector<Open>, std::greater<Open>> open;
+		const glm::vec3 target = m_positions[to];
+		const auto relax = [&](const std::uint32_t edge, const std::uint32_t parent, const float cost) {
+			if (m_stamps[edge] == m_stamp && m_costs[edge] <= cost) {
+				return;
+			}
+			m_stamps[edge] = m_stamp;
+			m_costs[edge] = cost;
+			m_parents[edge] = parent;
+			open.push({ cost + estimate(edge, target), cost, edge });
+		};
+
+		for (std::uint32_t i = 0; i < m_graph->getLeavingCount(from); i++) {
+			const std::uint32_t edge = m_graph->getLeaving(from, i);
+			relax(edge, TrackGraph::None, m_lengths[edge]);
+		}
+
+		while (!open.empty()) {
+			const Open top = open.top();
+			open.pop();
+			if (top.cost > m_costs[top.edge]) {
+				// a shorter way to this edge was found after it was queued
+				continue;
+			}
+			if (m_ends[top.edge] == to) {
+				route.length = top.cost;
+				for (std::uint32_t edge = top.edge; edge != TrackGraph::None; edge = m_parents[edge]) {
+					route.edges.push_back(edge);
+				}
+				std::reverse(route.edges.begin(), route.edges.end());
+				return route;
+			}
+			const std::uint32_t options = m_graph->getOptionCount(top.edge);
+			for (std::uint32_t i = 0; i < options; i++) {
+				const std::uint32_t next = m_graph->getOption(top.edge, i);
+				relax(next, top.edge, top.cost + m_lengths[next]);
+			}
+		}
+		return route;
+	}
+
+private:
+	const TrackGraph * m_graph;
+	std::size_t m_cacheSize;
+	std::size_t m_landmarkCount;
+	std::uint64_t m_revision;
+
+private:
+	// most recently used first, the map points into the list
+	std::list<std::pair<Key, Route>> m_order;
+	std::unordered_map<Key, std::list<std::pair<Key, Route>>::iterator, KeyHash> m_entries;
+	Route m_uncached;
+	std::size_t m_hits;
+	std::size_t m_misses;
+
+private:
+	// arc length and end node of every edge copied next to each other, so that the search never leaves them
+	std::vector<float> m_lengths;
+	std::vector<std::uint32_t> m_ends;
+	std::vector<glm::vec3> m_positions;
+	std::vector<std::uint32_t> m_predecessorOffsets;
+	std::vector<std::uint32_t> m_predecessors;
+	std::vector<std::uint32_t> m_arrivingOffsets;
+	std::vector<std::uint32_t> m_arriving;
+
+private:
+	// arc lengths from every landmark to every edge and back, m_forward[edge * landmarks + l]
+	std::vector<std::uint32_t> m_landmarks;
+	std::vector<float> m_forward;
+	std::vector<float> m_backward;
+	// bounds of the current target, the closest way from each landmark and the furthest way back to it
+	std::vector<float> m_goalForward;
+	std::vector<float> m_goalBackward;
+
+private:
+	std::vector<float> m_costs;
+	std::vector<std::uint32_t> m_parents;
+	std::vector<std::uint32_t> m_stamps;
+	std::uint32_t m_stamp;
+};
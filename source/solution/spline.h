@@ -1,18 +1,95 @@
 #pragma once
 
+#include <algorithm>
+#include <thread>
+
 #include "spline_segment.h"
+#include "spline_segment_view.h"
+
+class Spline;
+
+// segments [firstSegment, lastSegment) covering points [firstPoint, lastPoint)
+struct SplineRange {
+	std::size_t firstSegment;
+	std::size_t lastSegment;
+	std::size_t firstPoint;
+	std::size_t lastPoint;
+};
+
+// curve geometry at one point, derivatives are taken by the segment parameter
+struct SplineSample {
+	glm::vec3 position;
+	glm::vec3 velocity;
+	glm::vec3 acceleration;
+	// unit tangent, unit principal normal (zero on straight track) and curvature as inverse radius
+	glm::vec3 tangent;
+	glm::vec3 normal;
+	float curvature;
+};
+
+class SplineSegmentIterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = SplineSegmentView;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const SplineSegmentView *;
+	using reference = SplineSegmentView;
+
+	SplineSegmentIterator(const Spline * spline, const std::size_t idx) : m_spline(spline), m_idx(idx) {}
+
+public:
+	SplineSegmentView operator*() const;
+
+	SplineSegmentIterator & operator++() {
+		++m_idx;
+		return *this;
+	}
+
+	SplineSegmentIterator operator++(int) {
+		SplineSegmentIterator result = *this;
+		++m_idx;
+		return result;
+	}
+
+	bool operator==(const SplineSegmentIterator & other) const {
+		return m_spline == other.m_spline && m_idx == other.m_idx;
+	}
+
+	bool operator!=(const SplineSegmentIterator & other) const {
+		return !(*this == other);
+	}
+
+private:
+	const Spline * m_spline;
+	std::size_t m_idx;
+};
 
 class Spline {
 public:
-	Spline() : m_segments({}), m_isLoop(false) {}
-	explicit Spline(const bool isLoop) : m_segments({}), m_isLoop(isLoop) {}
+	Spline() : m_isAdaptive(false), m_precision(.0f), m_offsets({ 0 }), m_isLoop(false) {}
+	explicit Spline(const bool isLoop) : m_isAdaptive(false), m_precision(.0f), m_offsets({ 0 }), m_isLoop(isLoop) {}
 
 	explicit Spline(const std::initializer_list<SplineSegment> & segments, const bool isLoop = false) :
-		m_segments(segments),
-		m_isLoop(isLoop) {}
+		m_isAdaptive(false),
+		m_precision(.0f),
+		m_offsets({ 0 }),
+		m_isLoop(isLoop) {
+		glm::vec3 back;
+		for (const auto & segment : segments) {
+			for (const auto & line : segment) {
+				m_points.pushBack(line.getFirst());
+				back = line.getSecond();
+			}
+			m_offsets.push_back(m_points.size());
+		}
+		if (!m_points.empty()) {
+			m_points.pushBack(back);
+		}
+		index();
+	}
 
 	explicit Spline(const std::vector<glm::vec3> & path, const float eps = 0.01f,
-	                const bool isLoop = false) : m_segments({}), m_isLoop(isLoop) {
+	                const bool isLoop = false) : m_isAdaptive(false), m_precision(eps), m_offsets({ 0 }), m_isLoop(isLoop) {
 		construct(path, eps, isLoop);
 	}
 
@@ -25,163 +102,454 @@ public:
 	Spline & operator=(Spline &&) noexcept = default;
 
 public:
-	Spline & construct(const std::vector<glm::vec3> & path, const float eps = 0.01f, const bool isLoop = false) {
-		m_isLoop = isLoop;
-		if (m_segments.empty()) {
-			m_segments.clear();
-			m_segments.reserve(path.size());
-		}
-		for (std::size_t i = 0; i < path.size(); i++) {
-			auto i0 = glm::clamp<std::size_t>(i - 1, 0, path.size() - 1);
-			auto i1 = glm::clamp<std::size_t>(i, 0, path.size() - 1);
-			auto i2 = glm::clamp<std::size_t>(i + 1, 0, path.size() - 1);
-			auto i3 = glm::clamp<std::size_t>(i + 2, 0, path.size() - 1);
-
-			if (m_isLoop) {
-				if (i == 0) {
-					i0 = path.size() - 1;
-				} else if (i == path.size() - 2) {
-					i3 = 0;
-				} else if (i == path.size() - 1) {
-					i2 = 0;
-					i3 = path.size() == 1 ? 0 : 1;
-				}
+	// threads splits the segments into contiguous ranges built concurrently, 0 uses every hardware thread,
+	// the result does not depend on the number of threads
+	Spline & construct(const std::vector<glm::vec3> & path, const float eps = 0.01f, const bool isLoop = false,
+	                   const std::size_t threads = 1) {
+		m_controlPoints = path;
+		m_isAdaptive = false;
+		m_precision = eps;
+		m_points.reserve(path.size() * SplineSegment::lineCount(eps) + 1);
+		return build(isLoop, threads);
+	}
+
+	// tessellates every segment just finely enough to keep its lines within tolerance metres of the curve
+	Spline & constructAdaptive(const std::vector<glm::vec3> & path, const float tolerance = 0.01f,
+	                           const bool isLoop = false, const std::size_t threads = 1) {
+		m_controlPoints = path;
+		m_isAdaptive = true;
+		m_precision = tolerance;
+		return build(isLoop, threads);
+	}
+
+	// moves one control point and re-tessellates only the (at most four) segments it shapes,
+	// returns the re-tessellated ranges, a range that changed its line count shifts every index after it
+	std::vector<SplineRange> updateControlPoint(const std::size_t idx, const glm::vec3 & point) {
+		std::vector<SplineRange> result;
+		if (idx >= m_controlPoints.size()) {
+			return result;
+		}
+		m_controlPoints[idx] = point;
+
+		std::vector<std::size_t> segments;
+		for (std::size_t i = 0; i < 4; i++) {
+			// segment s is shaped by control points s - 1 to s + 2
+			const std::size_t segment = m_isLoop
+				                            ? (idx + 2 * m_controlPoints.size() + i - 2) % m_controlPoints.size()
+				                            : idx + i - 2;
+			if (segment < size() && std::find(segments.begin(), segments.end(), segment) == segments.end()) {
+				segments.push_back(segment);
+			}
+		}
+		std::sort(segments.begin(), segments.end());
+
+		for (const auto segment : segments) {
+			retessellate(segment);
+			if (!result.empty() && result.back().lastSegment == segment) {
+				++result.back().lastSegment;
 			} else {
-				if (i1 == path.size() - 1) {
-					break;
-				}
+				result.push_back({ segment, segment + 1, 0, 0 });
 			}
-			m_segments.emplace_back(std::move(SplineSegment().construct(path[i0], path[i1], path[i2], path[i3], eps)));
 		}
-		return *this;
+		for (auto & range : result) {
+			range.firstPoint = m_offsets[range.firstSegment];
+			range.lastPoint = range.lastSegment == size() ? m_points.size() : m_offsets[range.lastSegment];
+		}
+		return result;
 	}
 
 	float distance() const {
-		float res = .0f;
-		for (const auto & segment : m_segments) {
-			res += segment.distance();
-		}
-		for (std::size_t i = 0; i < m_segments.size() - 1; i++) {
-			const glm::vec3 front = m_segments[i + 1].getFront().getFirst();
-			const glm::vec3 back = m_segments[i].getBack().getSecond();
-			res += glm::distance(front, back);
+		return m_distances.empty() ? .0f : m_distances.back();
+	}
+
+	glm::vec3 get(const float dt) const {
+		const float interval = glm::fract(dt) * static_cast<float>(size());
+		const auto idx = glm::clamp<std::size_t>(static_cast<std::size_t>(interval), 0, size() - 1);
+		return operator[](idx).get(interval);
+	}
+
+	// arc length s wrapped for loops and clamped otherwise, expects at least one line
+	float wrap(const float s) const {
+		const float total = m_distances.back();
+		return m_isLoop && total > .0f ? s - total * glm::floor(s / total) : glm::clamp(s, .0f, total);
+	}
+
+	// wraps or clamps s and returns the line it falls on, expects at least one line
+	std::size_t locate(float & s) const {
+		s = wrap(s);
+
+		// m_distances[k] is the arc length at the first point of the k-th line
+		const auto it = std::upper_bound(m_distances.begin() + 1, m_distances.end() - 1, s);
+		return static_cast<std::size_t>(it - m_distances.begin()) - 1;
+	}
+
+	// point at arc length s from the start of the spline, wrapped for loops and clamped otherwise
+	glm::vec3 getAtDistance(float s) const {
+		if (m_distances.size() < 2) {
+			return empty() ? glm::vec3(.0f) : m_points.get(0);
 		}
-		if (!m_segments.empty() && m_isLoop) {
-			const glm::vec3 front = m_segments.front().getFront().getFirst();
-			const glm::vec3 back = m_segments.back().getBack().getSecond();
-			res += glm::distance(front, back);
+		const std::size_t k = locate(s);
+		return lerp(k, s);
+	}
+
+	// analytic geometry of a segment at curve parameter t in [0, 1]
+	SplineSample sample(const std::size_t segment, const float t) const {
+		if (m_controlPoints.empty()) {
+			// no curve behind a spline built point by point, fall back to its lines
+			const std::size_t lines = m_offsets[segment + 1] - m_offsets[segment];
+			const float interval = glm::clamp(t, .0f, 1.0f) * static_cast<float>(lines);
+			const std::size_t idx = glm::min(static_cast<std::size_t>(interval), lines - 1);
+			const glm::vec3 first = m_points.get(m_offsets[segment] + idx);
+			const glm::vec3 line = m_points.get(m_offsets[segment] + idx + 1) - first;
+			const float length = glm::length(line);
+			return {
+				first + (interval - static_cast<float>(idx)) * line, line, glm::vec3(.0f),
+				length > .0f ? line / length : glm::vec3(.0f), glm::vec3(.0f), .0f
+			};
 		}
-		return res;
+
+		const CatmullRom curve = getCurve(segment);
+		SplineSample result;
+		result.position = curve.get(t);
+		result.velocity = curve.getDerivative(t);
+		result.acceleration = curve.getSecondDerivative(t);
+
+		const float speed = glm::length(result.velocity);
+		result.tangent = speed > .0f ? result.velocity / speed : glm::vec3(.0f);
+		const glm::vec3 bend = result.acceleration - glm::dot(result.acceleration, result.tangent) * result.tangent;
+		const float bendLength = glm::length(bend);
+		result.normal = bendLength > 1e-6f ? bend / bendLength : glm::vec3(.0f);
+		result.curvature = speed > .0f
+			                   ? glm::length(glm::cross(result.velocity, result.acceleration)) / (speed * speed * speed)
+			                   : .0f;
+		return result;
 	}
 
-	glm::vec3 get(const float dt) const {
-		const float interval = glm::fract(dt) * static_cast<float>(m_segments.size());
-		const auto idx = glm::clamp<std::size_t>(static_cast<std::size_t>(interval), 0, m_segments.size() - 1);
-		return m_segments[idx].get(interval);
+	// analytic geometry at arc length s, wrapped for loops and clamped otherwise, expects a non-empty spline
+	SplineSample sampleAtDistance(float s) const {
+		const std::size_t k = locate(s);
+		const std::size_t segment = getSegment(k);
+		const float length = m_distances[k + 1] - m_distances[k];
+		const float dt = length > .0f ? glm::clamp((s - m_distances[k]) / length, .0f, 1.0f) : .0f;
+		return sample(segment, getParameter(segment, k, dt));
+	}
+
+	// analytic geometry at the k-th tessellated point, expects a non-empty spline
+	SplineSample samplePoint(const std::size_t k) const {
+		// the last point ends the last line
+		const std::size_t line = glm::min(k, m_offsets.back() - 1);
+		const std::size_t segment = getSegment(line);
+		return sample(segment, getParameter(segment, line, k == line ? .0f : 1.0f));
 	}
 
 public:
 	void pushBack(const glm::vec3 & point) {
-		if (!empty()) {
-			m_segments.back().pushBack(point);
+		// the spline no longer follows its control points
+		m_controlPoints.clear();
+		m_isAdaptive = false;
+		m_parameters.clear();
+
+		if (m_points.empty()) {
+			m_points.pushBack(point);
+			m_points.pushBack(point);
+			m_offsets = { 0, 1 };
+			m_distances = { .0f, .0f };
+			return;
+		}
+
+		// either close the degenerate last line or append a new one
+		const std::size_t last = m_points.size() - 1;
+		if (m_points.get(last - 1) == m_points.get(last)) {
+			m_points.set(last, point);
+			m_distances.pop_back();
 		} else {
-			m_segments.emplace_back(point);
+			m_points.pushBack(point);
+			++m_offsets.back();
 		}
+		m_distances.push_back(m_distances.back() + glm::distance(m_points.get(m_points.size() - 2), point));
 	}
 
 	std::vector<glm::vec3> toVector() const {
 		std::vector<glm::vec3> result;
-		result.reserve(m_segments.size());
-		for (const auto & segment : m_segments) {
-			std::vector<glm::vec3> points = segment.toVector();
-			result.insert(result.end(), points.begin(), points.end());
+		if (m_points.empty()) {
+			return result;
 		}
-		if (!m_segments.empty() && m_isLoop) {
-			result.emplace_back(m_segments.back().getBack().getSecond());
+		const std::size_t size = m_isLoop ? m_points.size() : m_points.size() - 1;
+		result.reserve(size);
+		for (std::size_t k = 0; k < size; k++) {
+			result.emplace_back(m_points.get(k));
 		}
 		return result;
 	}
 
 public:
-	static Spline approx(const Spline & spline, const std::size_t n = 60, const float eps = .001f) {
+	// n points evenly spaced by arc length in a single pass over the lines, a loop does not repeat its start
+	static Spline resample(const Spline & spline, const std::size_t n = 60) {
 		Spline result(spline.isLoop());
-		float haul = .0f;
-		float minimum = std::numeric_limits<float>::max();
-		const float interval = spline.distance() / static_cast<float>(n);
-		float dt = eps;
-		do {
-			if (result.empty()) {
-				result.pushBack(spline.get(dt - eps));
-				continue;
+		const std::vector<float> & distances = spline.m_distances;
+		if (n == 0 || distances.size() < 2) {
+			return result;
+		}
+
+		const std::size_t intervals = spline.isLoop() || n == 1 ? n : n - 1;
+		const float interval = spline.distance() / static_cast<float>(intervals);
+
+		std::size_t k = 0;
+		for (std::size_t i = 0; i < n; i++) {
+			const float s = interval * static_cast<float>(i);
+			while (k + 2 < distances.size() && distances[k + 1] <= s) {
+				++k;
 			}
+			result.pushBack(spline.lerp(k, s));
+		}
+		return result;
+	}
 
-			const glm::vec3 p1 = spline.get(dt - eps);
-			const glm::vec3 p2 = spline.get(dt);
+public:
+	SplineSegmentView operator[](const std::size_t idx) const {
+		return { &m_points, m_distances.data(), m_offsets[idx], m_offsets[idx + 1] };
+	}
 
-			const float dx = p2.x - p1.x;
-			const float dy = p2.y - p1.y;
-			const float dz = p2.z - p1.z;
+	bool empty() const noexcept {
+		return size() == 0;
+	}
 
-			const float vx = dx * dt;
-			const float vy = dy * dt;
-			const float vz = dz * dt;
+	std::size_t size() const noexcept {
+		return m_offsets.size() - 1;
+	}
 
-			const float velocity = sqrtf(vx * vx + vy * vy + vz * vz);
-			haul += velocity / dt;
-			const float delta = fabs(haul - interval);
+public:
+	SplineSegmentIterator begin() const noexcept {
+		return { this, 0 };
+	}
 
-			if (delta < minimum) {
-				minimum = delta;
-				dt += eps;
-			} else {
-				haul = .0f;
-				minimum = std::numeric_limits<float>::max();
-				result.pushBack(p2);
-			}
-		} while (dt <= 1.0f);
+	SplineSegmentIterator end() const noexcept {
+		return { this, size() };
+	}
+
+public:
+	bool isLoop() const {
+		return m_isLoop;
+	}
+
+	const std::vector<glm::vec3> & getControlPoints() const {
+		return m_controlPoints;
+	}
+
+	const SplinePoints & getPoints() const {
+		return m_points;
+	}
+
+	const std::vector<std::size_t> & getOffsets() const {
+		return m_offsets;
+	}
+
+	// number of lines every segment was tessellated into
+	std::vector<std::size_t> getLineCounts() const {
+		std::vector<std::size_t> result;
+		result.reserve(size());
+		for (std::size_t i = 0; i < size(); i++) {
+			result.push_back(m_offsets[i + 1] - m_offsets[i]);
+		}
 		return result;
 	}
 
-	static Spline approx2(const Spline & spline, const std::size_t n = 60, const float eps = .001f) {
-		return approx(approx(spline, n, eps), n, eps);
+	const std::vector<float> & getDistances() const {
+		return m_distances;
 	}
 
-public:
-	const SplineSegment & operator[](const std::size_t idx) const {
-		return m_segments.operator[](idx);
+private:
+	Spline & build(const bool isLoop, std::size_t threads) {
+		m_isLoop = isLoop;
+		m_points.clear();
+		m_parameters.clear();
+		m_offsets.assign(1, 0);
+
+		const std::size_t count = m_controlPoints.empty() ? 0 : isLoop ? m_controlPoints.size() : m_controlPoints.size() - 1;
+		m_offsets.reserve(count + 1);
+
+		if (threads == 0) {
+			threads = glm::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+		}
+		threads = glm::min(threads, count);
+
+		glm::vec3 back;
+		if (threads <= 1) {
+			for (std::size_t i = 0; i < count; i++) {
+				back = tessellate(i, m_points, m_parameters);
+				m_offsets.push_back(m_points.size());
+			}
+		} else {
+			// every thread owns one contiguous range of segments, ranges are stitched in order afterwards
+			struct Range {
+				SplinePoints points;
+				std::vector<float> parameters;
+				std::vector<std::size_t> offsets;
+				glm::vec3 back;
+			};
+			std::vector<Range> ranges(threads);
+			std::vector<std::thread> workers;
+			workers.reserve(threads);
+			for (std::size_t t = 0; t < threads; t++) {
+				workers.emplace_back([this, &ranges, count, threads, t]() {
+					Range & range = ranges[t];
+					const std::size_t first = count * t / threads;
+					const std::size_t last = count * (t + 1) / threads;
+					range.offsets.reserve(last - first);
+					for (std::size_t i = first; i < last; i++) {
+						range.back = tessellate(i, range.points, range.parameters);
+						range.offsets.push_back(range.points.size());
+					}
+				});
+			}
+			for (auto & worker : workers) {
+				worker.join();
+			}
+
+			for (const auto & range : ranges) {
+				const std::size_t base = m_points.size();
+				m_points.append(range.points);
+				m_parameters.insert(m_parameters.end(), range.parameters.begin(), range.parameters.end());
+				for (const auto offset : range.offsets) {
+					m_offsets.push_back(base + offset);
+				}
+				back = range.back;
+			}
+		}
+		if (!m_points.empty()) {
+			m_points.pushBack(back);
+			if (m_isAdaptive) {
+				m_parameters.push_back(1.0f);
+			}
+		}
+		index();
+		return *this;
 	}
 
-	bool empty() const noexcept {
-		return m_segments.empty();
+	// appends the points of one segment built from the stored control points and, for adaptive splines, their
+	// curve parameters, returns its end point
+	glm::vec3 tessellate(const std::size_t segment, SplinePoints & points, std::vector<float> & parameters) const {
+		const glm::vec3 & p1 = m_controlPoints[getControl(segment, -1)];
+		const glm::vec3 & p2 = m_controlPoints[getControl(segment, 0)];
+		const glm::vec3 & p3 = m_controlPoints[getControl(segment, 1)];
+		const glm::vec3 & p4 = m_controlPoints[getControl(segment, 2)];
+		return m_isAdaptive ? SplineSegment::tessellateAdaptive(p1, p2, p3, p4, points, parameters, m_precision)
+		                    : SplineSegment::tessellate(p1, p2, p3, p4, points, m_precision);
 	}
 
-public:
-	std::vector<SplineSegment>::iterator begin() noexcept {
-		return m_segments.begin();
+	// index of the control point at offset -1 to 2 from the start of the segment
+	std::size_t getControl(const std::size_t segment, const int offset) const {
+		const auto n = static_cast<std::ptrdiff_t>(m_controlPoints.size());
+		const auto idx = static_cast<std::ptrdiff_t>(segment) + offset;
+		return static_cast<std::size_t>(m_isLoop ? (idx + n) % n : glm::clamp<std::ptrdiff_t>(idx, 0, n - 1));
 	}
 
-	std::vector<SplineSegment>::iterator end() noexcept {
-		return m_segments.end();
+	CatmullRom getCurve(const std::size_t segment) const {
+		return {
+			m_controlPoints[getControl(segment, -1)], m_controlPoints[getControl(segment, 0)],
+			m_controlPoints[getControl(segment, 1)], m_controlPoints[getControl(segment, 2)]
+		};
 	}
 
-	std::vector<SplineSegment>::const_iterator begin() const noexcept {
-		return m_segments.cbegin();
+	// segment the k-th line belongs to
+	std::size_t getSegment(const std::size_t k) const {
+		return static_cast<std::size_t>(std::upper_bound(m_offsets.begin() + 1, m_offsets.end() - 1, k) - m_offsets.begin()) - 1;
 	}
 
-	std::vector<SplineSegment>::const_iterator end() const noexcept {
-		return m_segments.cend();
+	// curve parameter at fraction dt of the k-th line
+	float getParameter(const std::size_t segment, const std::size_t k, const float dt) const {
+		if (!m_isAdaptive) {
+			// lines of a uniform tessellation and of a spline built point by point split their segment evenly
+			return (static_cast<float>(k - m_offsets[segment]) + dt) /
+			       static_cast<float>(m_offsets[segment + 1] - m_offsets[segment]);
+		}
+		// the last point of a segment is the first one of the next, at parameter 0 of that one
+		const float t2 = k + 1 == m_offsets[segment + 1] ? 1.0f : m_parameters[k + 1];
+		return glm::mix(m_parameters[k], t2, dt);
 	}
 
-public:
-	const std::vector<SplineSegment> & getSegments() const {
-		return m_segments;
+	// replaces the points of one segment and patches offsets and arc lengths of everything after it
+	void retessellate(const std::size_t segment) {
+		SplinePoints points;
+		std::vector<float> parameters;
+		const glm::vec3 back = tessellate(segment, points, parameters);
+
+		const std::size_t first = m_offsets[segment];
+		const std::size_t last = m_offsets[segment + 1];
+		m_points.replace(first, last, points);
+		if (m_isAdaptive) {
+			m_parameters.erase(m_parameters.begin() + first, m_parameters.begin() + last);
+			m_parameters.insert(m_parameters.begin() + first, parameters.begin(), parameters.end());
+		}
+		if (points.size() != last - first) {
+			const std::size_t size = points.size();
+			for (std::size_t i = segment + 1; i < m_offsets.size(); i++) {
+				m_offsets[i] = m_offsets[i] - (last - first) + size;
+			}
+			if (size > last - first) {
+				m_distances.insert(m_distances.begin() + last, size - (last - first), .0f);
+			} else {
+				m_distances.erase(m_distances.begin() + first + size, m_distances.begin() + last);
+			}
+		}
+		if (segment + 1 == size()) {
+			m_points.set(m_points.size() - 1, back);
+		}
+
+		// lines of the segment up to the start of the next one, later arc lengths move by the same amount
+		const std::size_t end = m_offsets[segment + 1];
+		const float before = m_distances[end];
+		m_distances[first] = first == 0 ? .0f : m_distances[first - 1] + glm::distance(m_points.get(first - 1), m_points.get(first));
+		for (std::size_t k = first + 1; k <= end; k++) {
+			m_distances[k] = m_distances[k - 1] + glm::distance(m_points.get(k - 1), m_points.get(k));
+		}
+		const float shift = m_distances[end] - before;
+		for (std::size_t k = end + 1; k < m_distances.size(); k++) {
+			m_distances[k] += shift;
+		}
 	}
 
-	bool isLoop() const {
-		return m_isLoop;
+	// rebuilds the cumulative arc length of every point
+	void index() {
+		m_distances.clear();
+		if (m_points.empty()) {
+			return;
+		}
+
+		m_distances.reserve(m_points.size());
+		m_distances.push_back(.0f);
+		for (std::size_t k = 1; k < m_points.size(); k++) {
+			m_distances.push_back(m_distances.back() + glm::distance(m_points.get(k - 1), m_points.get(k)));
+		}
+	}
+
+	// point at arc length s on the k-th line
+	glm::vec3 lerp(const std::size_t k, const float s) const {
+		const glm::vec3 first = m_points.get(k);
+		const float length = m_distances[k + 1] - m_distances[k];
+		const float dt = length > .0f ? glm::clamp((s - m_distances[k]) / length, .0f, 1.0f) : .0f;
+		return first + dt * (m_points.get(k + 1) - first);
 	}
 
 private:
-	std::vector<SplineSegment> m_segments;
+	// control points and tessellation settings of the last construct, empty for splines built point by point
+	std::vector<glm::vec3> m_controlPoints;
+	bool m_isAdaptive;
+	float m_precision;
+
+private:
+	// point k starts line k, the last point ends the last line
+	SplinePoints m_points;
+	// curve parameter of every point of an adaptive tessellation, empty otherwise: a uniform tessellation
+	// implies it by the index of the line within its segment
+	std::vector<float> m_parameters;
+	// first line index of every segment followed by the total line count
+	std::vector<std::size_t> m_offsets;
+	// arc length at every point
+	std::vector<float> m_distances;
 	bool m_isLoop;
 };
+
+inline SplineSegmentView SplineSegmentIterator::operator*() const {
+	return (*m_spline)[m_idx];
+}
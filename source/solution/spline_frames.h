@@ -0,0 +1,191 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/gtc/quaternion.hpp"
+
+#include "spline.h"
+
+// orthonormal basis of the track at one point, right = cross(tangent, up)
+struct SplineFrame {
+	glm::vec3 position;
+	glm::vec3 tangent;
+	glm::vec3 up;
+	glm::vec3 right;
+
+	// rotation of an object looking along the track, same convention as quatLookAt
+	glm::quat getRotation() const {
+		return glm::quatLookAt(tangent, up);
+	}
+};
+
+// rotation-minimizing frames at every tessellated point of a spline built by double reflection,
+// the spline must outlive the frames and they have to be rebuilt after it changes
+class SplineFrames {
+public:
+	explicit SplineFrames(const Spline & spline, const glm::vec3 & up = { .0f, 1.0f, .0f })
+		: m_spline(&spline), m_up(up) {
+		build();
+	}
+
+public:
+	void build() {
+		const SplinePoints & points = m_spline->getPoints();
+		const std::size_t n = points.size();
+		m_tangents.resize(n);
+		m_ups.resize(n);
+		if (n == 0) {
+			return;
+		}
+
+		for (std::size_t k = 0; k < n; k++) {
+			m_tangents[k] = m_spline->samplePoint(k).tangent;
+			if (m_tangents[k] == glm::vec3(.0f)) {
+				m_tangents[k] = k > 0 ? m_tangents[k - 1] : glm::vec3(.0f, .0f, -1.0f);
+			}
+		}
+
+		// the first frame keeps the world up as close as the tangent allows
+		m_ups[0] = orthogonalize(m_up, m_tangents[0]);
+		for (std::size_t k = 0; k + 1 < n; k++) {
+			m_ups[k + 1] = reflect(points.get(k), points.get(k + 1), m_tangents[k], m_tangents[k + 1], m_ups[k]);
+		}
+
+		// a loop ends where it starts, spread the twist it accumulated evenly over its length
+		const float total = m_spline->distance();
+		if (m_spline->isLoop() && n > 1 && total > .0f) {
+			const glm::vec3 & tangent = m_tangents[n - 1];
+			const float angle = glm::atan(glm::dot(glm::cross(m_ups[n - 1], m_ups[0]), tangent),
+			                              glm::dot(m_ups[n - 1], m_ups[0]));
+			const std::vector<float> & distances = m_spline->getDistances();
+			for (std::size_t k = 1; k < n; k++) {
+				m_ups[k] = rotate(m_ups[k], m_tangents[k], angle * distances[k] / total);
+			}
+		}
+	}
+
+public:
+	SplineFrame operator[](const std::size_t k) const {
+		const glm::vec3 & tangent = m_tangents[k];
+		const glm::vec3 & up = m_ups[k];
+		return { m_spline->getPoints().get(k), tangent, up, glm::cross(tangent, up) };
+	}
+
+	// frame at arc length s interpolated between the two closest points, wrapped for loops and clamped otherwise
+	SplineFrame get(float s) const {
+		if (m_tangents.empty()) {
+			return { glm::vec3(.0f), glm::vec3(.0f, .0f, -1.0f), m_up, glm::cross(glm::vec3(.0f, .0f, -1.0f), m_up) };
+		}
+		if (m_tangents.size() == 1) {
+			return operator[](0);
+		}
+
+		const std::size_t k = m_spline->locate(s);
+		return interpolate(k, s);
+	}
+
+	// frames at n arc lengths sorted in ascending order, found in one forward pass over the points
+	void get(const float * distances, const std::size_t n, SplineFrame * result) const {
+		if (m_tangents.size() < 2) {
+			for (std::size_t i = 0; i < n; i++) {
+				result[i] = get(distances[i]);
+			}
+			return;
+		}
+
+		const std::vector<float> & arcs = m_spline->getDistances();
+		std::size_t k = 0;
+		for (std::size_t i = 0; i < n; i++) {
+			float s = m_spline->wrap(distances[i]);
+			if (i == 0 || s < arcs[k]) {
+				// the first lookup and the one after a loop wraps around search from scratch
+				k = m_spline->locate(s);
+			} else {
+				while (k + 2 < arcs.size() && arcs[k + 1] <= s) {
+					++k;
+				}
+			}
+			result[i] = interpolate(k, s);
+		}
+	}
+
+	std::size_t size() const noexcept {
+		return m_tangents.size();
+	}
+
+	bool empty() const noexcept {
+		return m_tangents.empty();
+	}
+
+public:
+	const Spline & getSpline() const {
+		return *m_spline;
+	}
+
+	const std::vector<glm::vec3> & getTangents() const {
+		return m_tangents;
+	}
+
+	const std::vector<glm::vec3> & getUps() const {
+		return m_ups;
+	}
+
+private:
+	// frame at arc length s on the k-th line
+	SplineFrame interpolate(const std::size_t k, const float s) const {
+		const std::vector<float> & distances = m_spline->getDistances();
+		const float length = distances[k + 1] - distances[k];
+		const float dt = length > .0f ? glm::clamp((s - distances[k]) / length, .0f, 1.0f) : .0f;
+
+		const SplinePoints & points = m_spline->getPoints();
+		const glm::vec3 tangent = glm::normalize(glm::mix(m_tangents[k], m_tangents[k + 1], dt));
+		const glm::vec3 up = orthogonalize(glm::mix(m_ups[k], m_ups[k + 1], dt), tangent);
+		return { glm::mix(points.get(k), points.get(k + 1), dt), tangent, up, glm::cross(tangent, up) };
+	}
+
+	// carries the up vector from one point to the next, Wang et al. 2008
+	static glm::vec3 reflect(const glm::vec3 & p1, const glm::vec3 & p2, const glm::vec3 & t1, const glm::vec3 & t2,
+	                         const glm::vec3 & up) {
+		// mirror across the plane bisecting the two points
+		const glm::vec3 v1 = p2 - p1;
+		const float c1 = glm::dot(v1, v1);
+		if (c1 == .0f) {
+			return orthogonalize(up, t2);
+		}
+		const glm::vec3 upL = up - (2.0f / c1) * glm::dot(v1, up) * v1;
+		const glm::vec3 tL = t1 - (2.0f / c1) * glm::dot(v1, t1) * v1;
+
+		// then across the plane that maps the mirrored tangent onto the next one
+		const glm::vec3 v2 = t2 - tL;
+		const float c2 = glm::dot(v2, v2);
+		if (c2 == .0f) {
+			return orthogonalize(upL, t2);
+		}
+		return orthogonalize(upL - (2.0f / c2) * glm::dot(v2, upL) * v2, t2);
+	}
+
+	// unit part of v perpendicular to the unit tangent, any perpendicular if v is parallel to it
+	static glm::vec3 orthogonalize(const glm::vec3 & v, const glm::vec3 & tangent) {
+		glm::vec3 result = v - glm::dot(v, tangent) * tangent;
+		if (glm::dot(result, result) < 1e-12f) {
+			const glm::vec3 axis = glm::abs(tangent.x) < .9f ? glm::vec3(1.0f, .0f, .0f) : glm::vec3(.0f, 1.0f, .0f);
+			result = axis - glm::dot(axis, tangent) * tangent;
+		}
+		return glm::normalize(result);
+	}
+
+	// rotates v by angle around the unit axis
+	static glm::vec3 rotate(const glm::vec3 & v, const glm::vec3 & axis, const float angle) {
+		const float cos = glm::cos(angle);
+		return v * cos + glm::cross(axis, v) * glm::sin(angle) + axis * glm::dot(axis, v) * (1.0f - cos);
+	}
+
+private:
+	const Spline * m_spline;
+	glm::vec3 m_up;
+
+private:
+	// per tessellated point, unit and perpendicular to each other
+	std::vector<glm::vec3> m_tangents;
+	std::vector<glm::vec3> m_ups;
+};
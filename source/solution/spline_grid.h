@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "spline.h"
+
+struct SplineHit {
+	// closest point on the track and its distance to the query point
+	glm::vec3 point;
+	float range;
+	// parameter accepted by Spline::get, arc length accepted by Spline::getAtDistance
+	float parameter;
+	float distance;
+	std::size_t segment;
+};
+
+// uniform hash grid over the tessellated lines of a spline, the spline must outlive the grid
+class SplineGrid {
+public:
+	explicit SplineGrid(const Spline & spline, const float cellSize = 1.0f)
+		: m_spline(&spline), m_cellSize(cellSize), m_min(0), m_max(0) {
+		build();
+	}
+
+public:
+	void build() {
+		m_cells.clear();
+		m_segmentCells.assign(m_spline->size(), {});
+		m_min = glm::ivec3(std::numeric_limits<int>::max());
+		m_max = glm::ivec3(std::numeric_limits<int>::min());
+		for (std::size_t segment = 0; segment < m_spline->size(); segment++) {
+			insert(segment);
+		}
+	}
+
+	// re-inserts the lines of one segment after it was re-tessellated, other segments are untouched
+	void update(const std::size_t segment) {
+		if (m_segmentCells.size() != m_spline->size()) {
+			build();
+			return;
+		}
+		for (const auto key : m_segmentCells[segment]) {
+			auto cell = m_cells.find(key);
+			if (cell == m_cells.end()) {
+				continue;
+			}
+			auto & entries = cell->second;
+			entries.erase(std::remove_if(entries.begin(), entries.end(), [segment](const Entry & entry) {
+				return entry.segment == segment;
+			}), entries.end());
+			if (entries.empty()) {
+				m_cells.erase(cell);
+			}
+		}
+		m_segmentCells[segment].clear();
+		insert(segment);
+	}
+
+public:
+	// closest point of the track no farther than maxRange, false if there is none
+	bool nearest(const glm::vec3 & point, SplineHit & hit,
+	             const float maxRange = std::numeric_limits<float>::max()) const {
+		if (m_cells.empty()) {
+			return false;
+		}
+
+		hit.range = maxRange;
+		bool found = false;
+		const glm::ivec3 center = cell(point);
+		const int rings = ringCount(center, maxRange);
+		for (int ring = 0; ring <= rings; ring++) {
+			// lines in this ring and beyond are at least ring - 1 cells away
+			if (found && hit.range <= static_cast<float>(ring - 1) * m_cellSize) {
+				break;
+			}
+			// only the part of the shell that overlaps occupied cells
+			const glm::ivec3 min = glm::max(center - ring, m_min);
+			const glm::ivec3 max = glm::min(center + ring, m_max);
+			for (int x = min.x; x <= max.x; x++) {
+				for (int y = min.y; y <= max.y; y++) {
+					for (int z = min.z; z <= max.z; z++) {
+						const glm::ivec3 idx(x, y, z);
+						const glm::ivec3 offset = glm::abs(idx - center);
+						if (glm::max(offset.x, glm::max(offset.y, offset.z)) != ring) {
+							// skip the inside of the shell, jump straight to its far face
+							if (z < center.z + ring && glm::max(offset.x, offset.y) != ring) {
+								z = center.z + ring - 1;
+							}
+							continue;
+						}
+						found |= visit(idx, point, [&hit](const SplineHit & candidate) {
+							if (candidate.range < hit.range) {
+								hit = candidate;
+								return true;
+							}
+							return false;
+						});
+					}
+				}
+			}
+		}
+		return found;
+	}
+
+	// closest point of every segment that passes within radius of the point
+	std::vector<SplineHit> radius(const glm::vec3 & point, const float radius) const {
+		std::vector<SplineHit> result;
+		const glm::ivec3 min = cell(point - glm::vec3(radius));
+		const glm::ivec3 max = cell(point + glm::vec3(radius));
+		for (int x = min.x; x <= max.x; x++) {
+			for (int y = min.y; y <= max.y; y++) {
+				for (int z = min.z; z <= max.z; z++) {
+					visit({ x, y, z }, point, [&result, radius](const SplineHit & candidate) {
+						if (candidate.range > radius) {
+							return false;
+						}
+						for (auto & hit : result) {
+							if (hit.segment == candidate.segment) {
+								if (candidate.range < hit.range) {
+									hit = candidate;
+								}
+								return true;
+							}
+						}
+						result.push_back(candidate);
+						return true;
+					});
+				}
+			}
+		}
+		return result;
+	}
+
+public:
+	float getCellSize() const {
+		return m_cellSize;
+	}
+
+	std::size_t getCellCount() const {
+		return m_cells.size();
+	}
+
+private:
+	struct Entry {
+		std::uint32_t segment;
+		std::uint32_t line;
+	};
+
+	void insert(const std::size_t segment) {
+		const SplineSegmentView view = (*m_spline)[segment];
+		const SplinePoints & points = m_spline->getPoints();
+		auto & keys = m_segmentCells[segment];
+		for (std::size_t line = 0; line < view.size(); line++) {
+			const std::size_t k = view.getOffset() + line;
+			const glm::vec3 p1 = points.get(k);
+			const glm::vec3 p2 = points.get(k + 1);
+			const glm::ivec3 min = cell(glm::min(p1, p2));
+			const glm::ivec3 max = cell(glm::max(p1, p2));
+			m_min = glm::min(m_min, min);
+			m_max = glm::max(m_max, max);
+			for (int x = min.x; x <= max.x; x++) {
+				for (int y = min.y; y <= max.y; y++) {
+					for (int z = min.z; z <= max.z; z++) {
+						const std::int64_t key = hash({ x, y, z });
+						m_cells[key].push_back({ static_cast<std::uint32_t>(segment), static_cast<std::uint32_t>(line) });
+						if (keys.empty() || keys.back() != key) {
+							keys.push_back(key);
+						}
+					}
+				}
+			}
+		}
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	}
+
+	// calls accept with the closest point of every line in the cell, true if it accepted any
+	template <typename Accept>
+	bool visit(const glm::ivec3 & idx, const glm::vec3 & point, Accept accept) const {
+		const auto cell = m_cells.find(hash(idx));
+		if (cell == m_cells.end()) {
+			return false;
+		}
+
+		const SplinePoints & points = m_spline->getPoints();
+		const std::vector<float> & distances = m_spline->getDistances();
+		const std::vector<std::size_t> & offsets = m_spline->getOffsets();
+		bool accepted = false;
+		for (const auto & entry : cell->second) {
+			const std::size_t k = offsets[entry.segment] + entry.line;
+			const glm::vec3 p1 = points.get(k);
+			const glm::vec3 line = points.get(k + 1) - p1;
+			const float length = glm::dot(line, line);
+			const float dt = length > .0f ? glm::clamp(glm::dot(point - p1, line) / length, .0f, 1.0f) : .0f;
+
+			SplineHit hit;
+			hit.point = p1 + dt * line;
+			hit.range = glm::distance(point, hit.point);
+			hit.segment = entry.segment;
+			hit.distance = glm::mix(distances[k], distances[k + 1], dt);
+			const float lines = static_cast<float>(offsets[entry.segment + 1] - offsets[entry.segment]);
+			hit.parameter = (static_cast<float>(entry.segment) + (static_cast<float>(entry.line) + dt) / lines)
+			                / static_cast<float>(m_spline->size());
+			accepted |= accept(hit);
+		}
+		return accepted;
+	}
+
+	// rings to search before giving up, bounded by the range and by the occupied part of the grid
+	int ringCount(const glm::ivec3 & center, const float maxRange) const {
+		const glm::ivec3 extent = glm::max(glm::abs(m_min - center), glm::abs(m_max - center));
+		const int rings = glm::max(extent.x, glm::max(extent.y, extent.z));
+		if (maxRange / m_cellSize < static_cast<float>(rings)) {
+			return static_cast<int>(maxRange / m_cellSize) + 1;
+		}
+		return rings;
+	}
+
+	glm::ivec3 cell(const glm::vec3 & point) const {
+		return glm::ivec3(glm::floor(point / m_cellSize));
+	}
+
+	// 21 bits per axis
+	static std::int64_t hash(const glm::ivec3 & idx) {
+		constexpr std::int64_t mask = (1 << 21) - 1;
+		return ((static_cast<std::int64_t>(idx.x) & mask) << 42) |
+		       ((static_cast<std::int64_t>(idx.y) & mask) << 21) |
+		       (static_cast<std::int64_t>(idx.z) & mask);
+	}
+
+private:
+	const Spline * m_spline;
+	float m_cellSize;
+
+private:
+	std::unordered_map<std::int64_t, std::vector<Entry>> m_cells;
+	// cells every segment was inserted into, used by update
+	std::vector<std::vector<std::int64_t>> m_segmentCells;
+	// bounds of every cell ever occupied since the last build
+	glm::ivec3 m_min;
+	glm::ivec3 m_max;
+};
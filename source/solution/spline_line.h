@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include "glm/vec3.hpp"
 
 class SplineLine {
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "glm/vec3.hpp"
+
+// structure-of-arrays point storage shared by all segments of a spline, 12 bytes per point
+class SplinePoints {
+public:
+	SplinePoints() = default;
+	~SplinePoints() = default;
+
+	SplinePoints(const SplinePoints &) = default;
+	SplinePoints(SplinePoints &&) noexcept = default;
+
+	SplinePoints & operator=(const SplinePoints &) = default;
+	SplinePoints & operator=(SplinePoints &&) noexcept = default;
+
+public:
+	glm::vec3 get(const std::size_t idx) const {
+		return { m_x[idx], m_y[idx], m_z[idx] };
+	}
+
+	void set(const std::size_t idx, const glm::vec3 & point) {
+		m_x[idx] = point.x;
+		m_y[idx] = point.y;
+		m_z[idx] = point.z;
+	}
+
+	void pushBack(const glm::vec3 & point) {
+		m_x.push_back(point.x);
+		m_y.push_back(point.y);
+		m_z.push_back(point.z);
+	}
+
+	void append(const SplinePoints & other) {
+		m_x.insert(m_x.end(), other.m_x.begin(), other.m_x.end());
+		m_y.insert(m_y.end(), other.m_y.begin(), other.m_y.end());
+		m_z.insert(m_z.end(), other.m_z.begin(), other.m_z.end());
+	}
+
+	// replaces points [first, last) with other, the storage grows or shrinks as needed
+	void replace(const std::size_t first, const std::size_t last, const SplinePoints & other) {
+		replace(m_x, first, last, other.m_x);
+		replace(m_y, first, last, other.m_y);
+		replace(m_z, first, last, other.m_z);
+	}
+
+	void resize(const std::size_t size) {
+		m_x.resize(size);
+		m_y.resize(size);
+		m_z.resize(size);
+	}
+
+	void reserve(const std::size_t size) {
+		m_x.reserve(size);
+		m_y.reserve(size);
+		m_z.reserve(size);
+	}
+
+	void clear() noexcept {
+		m_x.clear();
+		m_y.clear();
+		m_z.clear();
+	}
+
+public:
+	std::size_t size() const noexcept {
+		return m_x.size();
+	}
+
+	bool empty() const noexcept {
+		return m_x.empty();
+	}
+
+public:
+	const std::vector<float> & getX() const {
+		return m_x;
+	}
+
+	const std::vector<float> & getY() const {
+		return m_y;
+	}
+
+	const std::vector<float> & getZ() const {
+		return m_z;
+	}
+
+	float * getX(const std::size_t idx) {
+		return m_x.data() + idx;
+	}
+
+	float * getY(const std::size_t idx) {
+		return m_y.data() + idx;
+	}
+
+	float * getZ(const std::size_t idx) {
+		return m_z.data() + idx;
+	}
+
+private:
+	static void replace(std::vector<float> & to, const std::size_t first, const std::size_t last,
+	                    const std::vector<float> & from) {
+		const std::size_t common = std::min(last - first, from.size());
+		std::copy(from.begin(), from.begin() + common, to.begin() + first);
+		if (common < from.size()) {
+			to.insert(to.begin() + last, from.begin() + common, from.end());
+		} else {
+			to.erase(to.begin() + first + common, to.begin() + last);
+		}
+	}
+
+private:
+	std::vector<float> m_x;
+	std::vector<float> m_y;
+	std::vector<float> m_z;
+};
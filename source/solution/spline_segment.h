@@ -2,10 +2,11 @@
 
 #include <vector>
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include "glm/gtx/spline.hpp"
+#include "glm/glm.hpp"
 
+#include "catmull_rom.h"
 #include "spline_line.h"
+#include "spline_points.h"
 
 class SplineSegment {
 public:
@@ -27,14 +28,45 @@ public:
 public:
 	SplineSegment & construct(const glm::vec3 & p1, const glm::vec3 & p2, const glm::vec3 & p3, const glm::vec3 & p4,
 	                          const float eps = 0.01f) {
-		float dt = eps;
-		do {
-			m_lines.emplace_back(catmullRom(p1, p2, p3, p4, dt - eps), catmullRom(p1, p2, p3, p4, dt));
-			dt += eps;
-		} while (dt <= 1.0f);
+		SplinePoints points;
+		points.pushBack(tessellate(p1, p2, p3, p4, points, eps));
+		m_lines.reserve(m_lines.size() + points.size() - 1);
+		for (std::size_t k = 0; k < points.size() - 1; k++) {
+			m_lines.emplace_back(points.get(k), points.get(k + 1));
+		}
 		return *this;
 	}
 
+	// appends the first point of every line and returns the end point of the last one, line i starts at
+	// parameter i / lineCount(eps)
+	static glm::vec3 tessellate(const glm::vec3 & p1, const glm::vec3 & p2, const glm::vec3 & p3, const glm::vec3 & p4,
+	                            SplinePoints & points, const float eps = 0.01f) {
+		const std::size_t n = lineCount(eps);
+		const std::size_t first = points.size();
+		points.resize(first + n);
+
+		const float step = 1.0f / static_cast<float>(n);
+		const CatmullRom curve(p1, p2, p3, p4);
+		curve.evaluate(n, step, points.getX(first), points.getY(first), points.getZ(first));
+		return curve.get(1.0f);
+	}
+
+	// appends the first point of every line so that no line strays more than tolerance from the curve and
+	// its curve parameter, which the lines no longer imply, returns the end point of the last one
+	static glm::vec3 tessellateAdaptive(const glm::vec3 & p1, const glm::vec3 & p2, const glm::vec3 & p3,
+	                                    const glm::vec3 & p4, SplinePoints & points, std::vector<float> & parameters,
+	                                    const float tolerance = 0.01f) {
+		const CatmullRom curve(p1, p2, p3, p4);
+		const glm::vec3 back = curve.get(1.0f);
+		subdivide(curve, .0f, 1.0f, curve.get(.0f), back, tolerance, 0, points, parameters);
+		return back;
+	}
+
+	// number of lines a segment is tessellated into, every line spans eps of the parameter
+	static std::size_t lineCount(const float eps) {
+		return glm::max<std::size_t>(static_cast<std::size_t>(1.0f / eps + .5f), 1);
+	}
+
 	float distance() const {
 		float result = .0f;
 		for (const auto & line : m_lines) {
@@ -103,6 +135,10 @@ public:
 		return m_lines.empty();
 	}
 
+	std::size_t size() const noexcept {
+		return m_lines.size();
+	}
+
 public:
 	std::vector<SplineLine>::iterator begin() noexcept {
 		return m_lines.begin();
@@ -133,6 +169,34 @@ public:
 		return m_lines;
 	}
 
+private:
+	static void subdivide(const CatmullRom & curve, const float t1, const float t2, const glm::vec3 & p1,
+	                      const glm::vec3 & p2, const float tolerance, const int depth, SplinePoints & points,
+	                      std::vector<float> & parameters) {
+		static constexpr int maxDepth = 16;
+
+		// the offset of a cubic from its chord vanishes at both ends, three probes catch any bend
+		const glm::vec3 chord = p2 - p1;
+		const float length = glm::dot(chord, chord);
+		float deviation = .0f;
+		for (const float probe : { .25f, .5f, .75f }) {
+			const glm::vec3 offset = curve.get(glm::mix(t1, t2, probe)) - p1;
+			const float dt = length > .0f ? glm::clamp(glm::dot(offset, chord) / length, .0f, 1.0f) : .0f;
+			deviation = glm::max(deviation, glm::distance(offset, dt * chord));
+		}
+
+		if (deviation <= tolerance || depth == maxDepth) {
+			points.pushBack(p1);
+			parameters.push_back(t1);
+			return;
+		}
+
+		const float t = .5f * (t1 + t2);
+		const glm::vec3 middle = curve.get(t);
+		subdivide(curve, t1, t, p1, middle, tolerance, depth + 1, points, parameters);
+		subdivide(curve, t, t2, middle, p2, tolerance, depth + 1, points, parameters);
+	}
+
 private:
 	std::vector<SplineLine> m_lines;
 };
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "spline_line.h"
+#include "spline_points.h"
+
+// line k of a polyline connects points k and k + 1, lines are built on access
+class SplineLineIterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = SplineLine;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const SplineLine *;
+	using reference = SplineLine;
+
+	SplineLineIterator(const SplinePoints * points, const std::size_t idx) : m_points(points), m_idx(idx) {}
+
+public:
+	SplineLine operator*() const {
+		return { m_points->get(m_idx), m_points->get(m_idx + 1) };
+	}
+
+	SplineLineIterator & operator++() {
+		++m_idx;
+		return *this;
+	}
+
+	SplineLineIterator operator++(int) {
+		SplineLineIterator result = *this;
+		++m_idx;
+		return result;
+	}
+
+	bool operator==(const SplineLineIterator & other) const {
+		return m_points == other.m_points && m_idx == other.m_idx;
+	}
+
+	bool operator!=(const SplineLineIterator & other) const {
+		return !(*this == other);
+	}
+
+private:
+	const SplinePoints * m_points;
+	std::size_t m_idx;
+};
+
+// read-only segment over the flat storage of a spline, mirrors the SplineSegment interface
+class SplineSegmentView {
+public:
+	SplineSegmentView(const SplinePoints * points, const float * distances, const std::size_t first,
+	                  const std::size_t last) : m_points(points), m_distances(distances), m_first(first), m_last(last) {}
+
+public:
+	float distance() const {
+		return m_distances[m_last] - m_distances[m_first];
+	}
+
+	glm::vec3 get(const float dt) const {
+		const float interval = glm::fract(dt) * static_cast<float>(size());
+		const auto idx = glm::clamp<std::size_t>(static_cast<std::size_t>(interval), 0, size() - 1);
+		return operator[](idx).lerp(interval);
+	}
+
+	std::vector<glm::vec3> toVector() const {
+		std::vector<glm::vec3> result;
+		result.reserve(size());
+		for (std::size_t k = m_first; k < m_last; k++) {
+			result.emplace_back(m_points->get(k));
+		}
+		return result;
+	}
+
+public:
+	SplineLine operator[](const std::size_t idx) const {
+		return { m_points->get(m_first + idx), m_points->get(m_first + idx + 1) };
+	}
+
+	bool empty() const noexcept {
+		return m_first == m_last;
+	}
+
+	std::size_t size() const noexcept {
+		return m_last - m_first;
+	}
+
+public:
+	SplineLineIterator begin() const noexcept {
+		return { m_points, m_first };
+	}
+
+	SplineLineIterator end() const noexcept {
+		return { m_points, m_last };
+	}
+
+public:
+	SplineLine getFront() const {
+		return operator[](0);
+	}
+
+	SplineLine getBack() const {
+		return operator[](size() - 1);
+	}
+
+	// index of the first line of the segment within the whole spline
+	std::size_t getOffset() const {
+		return m_first;
+	}
+
+private:
+	const SplinePoints * m_points;
+	const float * m_distances;
+	std::size_t m_first;
+	std::size_t m_last;
+};
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "spline.h"
+
+// trapezoidal velocity profile from standstill to standstill: accelerate up to the speed, cruise and brake,
+// or only accelerate and brake when the distance is too short to reach the speed
+struct MotionProfile {
+	double distance;
+	double peak;
+	double acceleration;
+	double braking;
+	// seconds spent accelerating, cruising and braking
+	double accelerating;
+	double cruising;
+	double brakingTime;
+
+	static MotionProfile make(const double distance, const double speed, const double acceleration,
+	                          const double braking) {
+		MotionProfile result = { distance, speed, acceleration, braking, .0, .0, .0 };
+		if (distance <= .0) {
+			result.peak = .0;
+			return result;
+		}
+		const double ramps = speed * speed / (2.0 * acceleration) + speed * speed / (2.0 * braking);
+		if (ramps > distance) {
+			result.peak = std::sqrt(2.0 * acceleration * braking * distance / (acceleration + braking));
+		}
+		result.accelerating = result.peak / acceleration;
+		result.brakingTime = result.peak / braking;
+		result.cruising = ramps > distance ? .0 : (distance - ramps) / speed;
+		return result;
+	}
+
+	double getDuration() const {
+		return accelerating + cruising + brakingTime;
+	}
+
+	// distance covered t seconds after the start
+	double getDistance(double t) const {
+		if (t <= .0) {
+			return .0;
+		}
+		if (t < accelerating) {
+			return .5 * acceleration * t * t;
+		}
+		double result = .5 * peak * accelerating;
+		t -= accelerating;
+		if (t < cruising) {
+			return result + peak * t;
+		}
+		result += peak * cruising;
+		t = glm::min(t - cruising, brakingTime);
+		return glm::min(result + peak * t - .5 * braking * t * t, distance);
+	}
+
+	// seconds after the start at which the distance s is reached, the inverse of getDistance
+	double getTime(const double s) const {
+		if (s <= .0) {
+			return .0;
+		}
+		const double accelerated = .5 * peak * accelerating;
+		if (s < accelerated) {
+			return std::sqrt(2.0 * s / acceleration);
+		}
+		const double cruised = accelerated + peak * cruising;
+		if (s < cruised) {
+			return accelerating + (s - accelerated) / peak;
+		}
+		// the braking ramp read backwards from the end
+		const double left = glm::max(distance - s, .0);
+		return getDuration() - std::sqrt(2.0 * left / braking);
+	}
+};
+
+// stop of a timetabled train, arc lengths grow along the trip and may run over the end of a loop for more laps
+struct TimetableStop {
+	double distance;
+	// seconds the train stands before it leaves the stop
+	double dwell;
+};
+
+// discrete-event simulation of timetabled trains on one track with fixed blocks: time jumps from event to event
+// in a priority queue of departures, block entries, block exits and arrivals, and trains move analytically
+// between them, so a train standing or cruising costs nothing until its next event
+//
+// a train takes the free blocks ahead up to its next stop and runs to the signal at the end of them, where it
+// stops and asks again, or waits until the block ahead is released, it does not see a signal clear while it
+// runs towards it, times are in double precision seconds so that a day keeps its precision
+class Timetable {
+public:
+	enum class EventType {
+		Departure,
+		BlockEntry,
+		BlockExit,
+		SignalStop,
+		Arrival
+	};
+
+	// an enumerator rather than a static member so that it may be passed by reference without a definition
+	enum : std::uint32_t { None = 0xffffffff };
+
+	struct Event {
+		double time;
+		// ties at equal times are processed in the order they were queued
+		std::uint64_t sequence;
+		std::uint32_t train;
+		EventType type;
+		// stop ahead for departures, signal stops and arrivals, block for block entries and exits
+		std::int64_t index;
+
+		bool operator>(const Event & other) const {
+			return time != other.time ? time > other.time : sequence > other.sequence;
+		}
+	};
+
+	// blocks on a loop are stretched so that a whole number of them fits it
+	Timetable(const Spline & spline, const float blockLength, const float acceleration = .5f,
+	          const float braking = 1.0f)
+		: m_spline(&spline), m_acceleration(acceleration), m_braking(braking), m_time(.0), m_sequence(0),
+		  m_processed(0), m_last() {
+		const double total = spline.distance();
+		if (spline.isLoop()) {
+			m_count = glm::max<std::size_t>(static_cast<std::size_t>(glm::round(total / blockLength)), 1);
+			m_blockLength = total / static_cast<double>(m_count);
+		} else {
+			m_count = glm::max<std::size_t>(static_cast<std::size_t>(glm::ceil(total / blockLength)), 1);
+			m_blockLength = blockLength;
+		}
+		m_owners.assign(m_count, Free);
+		m_waiters.resize(m_count);
+	}
+
+public:
+	// train of the given length that leaves the first stop at the departure time and calls at the others,
+	// it takes the blocks under it, returns the train id or None without adding it if another train holds one
+	std::uint32_t addTrain(const double departure, const float speed, const float length,
+	                       std::vector<TimetableStop> stops) {
+		const auto id = static_cast<std::uint32_t>(m_trains.size());
+		const double from = stops.empty() ? .0 : stops.front().distance;
+		for (std::int64_t block = getBlock(from - length); block <= getBlock(from); block++) {
+			if (!isFree(block, id)) {
+				return None;
+			}
+		}
+
+		Train train;
+		train.speed = speed;
+		train.length = length;
+		train.stops = std::move(stops);
+		train.stop = 0;
+		train.start = departure;
+		train.profile = MotionProfile::make(.0, speed, m_acceleration, m_braking);
+		train.from = from;
+		train.to = train.from;
+		train.tail = getBlock(train.from - length);
+		train.head = getBlock(train.from);
+		train.reserved = train.head;
+		train.isRunning = false;
+		train.waiting = -1.0;
+		train.delay = .0;
+		for (std::int64_t block = train.tail; block <= train.head; block++) {
+			m_owners[getTrackBlock(block)] = id;
+		}
+		m_trains.push_back(std::move(train));
+		if (m_trains[id].stops.size() > 1) {
+			push(departure, id, EventType::Departure, 0);
+		}
+		return id;
+	}
+
+	// processes the next event, false if there is none
+	bool step() {
+		if (m_queue.empty()) {
+			return false;
+		}
+		const Event event = m_queue.top();
+		m_queue.pop();
+		m_time = event.time;
+		m_processed++;
+
+		switch (event.type) {
+			case EventType::Departure:
+				depart(event.train);
+				break;
+			case EventType::BlockEntry:
+				m_trains[event.train].head = event.index;
+				break;
+			case EventType::BlockExit:
+				release(event.train, event.index);
+				break;
+			case EventType::SignalStop:
+				m_trains[event.train].from = m_trains[event.train].to;
+				m_trains[event.train].isRunning = false;
+				depart(event.train);
+				break;
+			case EventType::Arrival:
+				arrive(event.train);
+				break;
+		}
+		m_last = event;
+		return true;
+	}
+
+	// processes every event up to the given time and moves the clock there, events after it stay queued
+	void run(const double until) {
+		while (!m_queue.empty() && m_queue.top().time <= until) {
+			step();
+		}
+		m_time = glm::max(m_time, until);
+	}
+
+public:
+	// arc length of the train head at a time no earlier than its last event, grows past the end of a loop
+	double getDistance(const std::uint32_t train, const double time) const {
+		const Train & state = m_trains[train];
+		if (!state.isRunning) {
+			return state.from;
+		}
+		return state.from + state.profile.getDistance(time - state.start);
+	}
+
+	// same wrapped onto the track
+	float getTrackDistance(const std::uint32_t train, const double time) const {
+		return m_spline->wrap(static_cast<float>(getDistance(train, time)));
+	}
+
+	// seconds the train spent waiting for blocks beyond its dwell times
+	double getDelay(const std::uint32_t train) const {
+		return m_trains[train].delay;
+	}
+
+	// last stop the train called at or left
+	std::size_t getStop(const std::uint32_t train) const {
+		return m_trains[train].stop;
+	}
+
+	bool isDone(const std::uint32_t train) const {
+		return m_trains[train].stop + 1 >= m_trains[train].stops.size() && !m_trains[train].isRunning;
+	}
+
+	// id of the train holding the block, getTrainCount() if none
+	std::size_t getOwner(const std::size_t block) const {
+		return m_owners[block] == Free ? m_trains.size() : m_owners[block];
+	}
+
+	double getTime() const {
+		return m_time;
+	}
+
+	const Event & getLastEvent() const {
+		return m_last;
+	}
+
+	std::size_t getProcessedCount() const {
+		return m_processed;
+	}
+
+	std::size_t getQueuedCount() const {
+		return m_queue.size();
+	}
+
+	std::size_t getTrainCount() const {
+		return m_trains.size();
+	}
+
+	std::size_t getBlockCount() const {
+		return m_count;
+	}
+
+	double getBlockLength() const {
+		return m_blockLength;
+	}
+
+private:
+	struct Train {
+		float speed;
+		float length;
+		std::vector<TimetableStop> stops;
+		std::size_t stop;
+		// the current run starts at from at the start time and follows the profile to to, or stands at from
+		double start;
+		double from;
+		double to;
+		MotionProfile profile;
+		bool isRunning;
+		// held blocks in order of travel, numbered along the trip so that they keep growing over laps
+		std::int64_t tail;
+		std::int64_t head;
+		std::int64_t reserved;
+		// time the train started to wait for a block, negative if it does not wait
+		double waiting;
+		double delay;
+	};
+
+	enum : std::uint32_t { Free = 0xffffffff };
+
+	void push(const double time, const std::uint32_t train, const EventType type, const std::int64_t index) {
+		m_queue.push({ time, m_sequence++, train, type, index });
+	}
+
+	// block of an arc length along the trip, blocks past the end of an open track are its last one
+	std::int64_t getBlock(const double distance) const {
+		const auto block = static_cast<std::int64_t>(std::floor(distance / m_blockLength));
+		if (m_spline->isLoop()) {
+			return block;
+		}
+		return glm::clamp<std::int64_t>(block, 0, static_cast<std::int64_t>(m_count) - 1);
+	}
+
+	std::size_t getTrackBlock(const std::int64_t block) const {
+		const auto count = static_cast<std::int64_t>(m_count);
+		return static_cast<std::size_t>(((block % count) + count) % count);
+	}
+
+	// takes the free blocks ahead up to the next stop and runs to the stop or to the end of the last one taken,
+	// waits for the block ahead if it is held
+	void depart(const std::uint32_t id) {
+		Train & train = m_trains[id];
+		const double stop = train.stops[train.stop + 1].distance;
+		// a train stopping exactly at a block end does not need the block behind it
+		const std::int64_t last = glm::max(getBlock(std::nextafter(stop, train.from)), train.head);
+
+		std::int64_t reserved = train.reserved;
+		while (reserved < last && isFree(reserved + 1, id)) {
+			reserved++;
+			m_owners[getTrackBlock(reserved)] = id;
+		}
+		if (reserved == train.head && reserved < last) {
+			m_waiters[getTrackBlock(reserved + 1)].push_back(id);
+			if (train.waiting < .0) {
+				train.waiting = m_time;
+			}
+			return;
+		}
+		if (train.waiting >= .0) {
+			train.delay += m_time - train.waiting;
+			train.waiting = -1.0;
+		}
+
+		train.reserved = reserved;
+		train.to = reserved == last ? stop : static_cast<double>(reserved + 1) * m_blockLength;
+		train.isRunning = true;
+		train.start = m_time;
+		train.profile = MotionProfile::make(train.to - train.from, train.speed, m_acceleration, m_braking);
+		for (std::int64_t block = train.head + 1; block <= reserved; block++) {
+			const double entry = static_cast<double>(block) * m_blockLength - train.from;
+			push(m_time + train.profile.getTime(entry), id, EventType::BlockEntry, block);
+		}
+		// blocks the tail clears during this run, the ones it clears later are scheduled by a later run
+		for (std::int64_t block = train.tail; block <= reserved; block++) {
+			const double exit = static_cast<double>(block + 1) * m_blockLength + train.length;
+			if (exit > train.from && exit <= train.to) {
+				push(m_time + train.profile.getTime(exit - train.from), id, EventType::BlockExit, block);
+			}
+		}
+		const EventType type = reserved == last ? EventType::Arrival : EventType::SignalStop;
+		push(m_time + train.profile.getDuration(), id, type, static_cast<std::int64_t>(train.stop + 1));
+	}
+
+	bool isFree(const std::int64_t block, const std::uint32_t id) const {
+		const std::uint32_t owner = m_owners[getTrackBlock(block)];
+		return owner == Free || owner == id;
+	}
+
+	void arrive(const std::uint32_t id) {
+		Train & train = m_trains[id];
+		train.from = train.to;
+		train.isRunning = false;
+		train.stop++;
+		if (train.stop + 1 < train.stops.size()) {
+			push(m_time + train.stops[train.stop].dwell, id, EventType::Departure, static_cast<std::int64_t>(train.stop));
+			return;
+		}
+		// the trip is over and the train leaves the track
+		for (std::int64_t block = train.tail; block <= train.reserved; block++) {
+			release(id, block);
+		}
+	}
+
+	// frees a block the tail left and retries the departures that wait for it
+	void release(const std::uint32_t id, const std::int64_t block) {
+		Train & train = m_trains[id];
+		train.tail = glm::max(train.tail, block + 1);
+		const std::size_t idx = getTrackBlock(block);
+		if (m_owners[idx] != id) {
+			return;
+		}
+		m_owners[idx] = Free;
+		for (const std::uint32_t waiter : m_waiters[idx]) {
+			push(m_time, waiter, EventType::Departure, static_cast<std::int64_t>(m_trains[waiter].stop));
+		}
+		m_waiters[idx].clear();
+	}
+
+private:
+	const Spline * m_spline;
+	double m_blockLength;
+	std::size_t m_count;
+	float m_acceleration;
+	float m_braking;
+
+private:
+	std::vector<Train> m_trains;
+	std::vector<std::uint32_t> m_owners;
+	// trains waiting to depart until a block is released
+	std::vector<std::vector<std::uint32_t>> m_waiters;
+	std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_queue;
+	double m_time;
+	std::uint64_t m_sequence;
+	std::size_t m_processed;
+	Event m_last;
+};
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "spline_frames.h"
+
+// triangles of both rails built without any GL state, the rails share their normals and indices
+struct RailsGeometry {
+	std::vector<glm::vec3> left;
+	std::vector<glm::vec3> right;
+	std::vector<glm::vec3> normals;
+	std::vector<unsigned int> indices;
+
+	// forwards and ups hold the basis of the track at least at every point but the last one
+	static RailsGeometry build(const std::vector<glm::vec3> & points, const std::vector<glm::vec3> & forwards,
+	                           const std::vector<glm::vec3> & ups, const bool loop, const float trackWidth,
+	                           const float railWidth) {
+		RailsGeometry result;
+		if (points.size() < 2) {
+			return result;
+		}
+
+		for (std::size_t i = 0; i < points.size() - 1; i++) {
+			const glm::vec3 right = cross(forwards[i], ups[i]);
+
+			result.left.push_back(points[i] - right * trackWidth * railWidth);
+			result.left.push_back(points[i] - right * trackWidth);
+
+			result.right.push_back(points[i] + right * trackWidth);
+			result.right.push_back(points[i] + right * trackWidth * railWidth);
+
+			result.normals.push_back(ups[i]);
+			result.normals.push_back(ups[i]);
+		}
+
+		for (unsigned int i = 0; i < points.size() * 2 - 4; i += 2) {
+			result.indices.push_back(i);
+			result.indices.push_back(i + 1);
+			result.indices.push_back(i + 2);
+
+			result.indices.push_back(i + 1);
+			result.indices.push_back(i + 3);
+			result.indices.push_back(i + 2);
+		}
+
+		if (!result.indices.empty() && loop) {
+			const auto size = static_cast<unsigned int>(result.left.size());
+			result.indices.push_back(size - 2);
+			result.indices.push_back(size - 1);
+			result.indices.push_back(0);
+
+			result.indices.push_back(size - 1);
+			result.indices.push_back(1);
+			result.indices.push_back(0);
+		}
+		return result;
+	}
+
+	// rails along the rotation-minimizing frames of the track
+	static RailsGeometry build(const SplineFrames & frames, const float trackWidth, const float railWidth) {
+		return build(frames.getSpline().toVector(), frames.getTangents(), frames.getUps(), frames.getSpline().isLoop(),
+		             trackWidth, railWidth);
+	}
+};
+
+// arc lengths of count ties evenly spaced along the track, a loop does not repeat its start
+inline std::vector<float> getTieDistances(const SplineFrames & frames, const std::size_t count) {
+	std::vector<float> result;
+	if (count == 0 || frames.empty()) {
+		return result;
+	}
+
+	const Spline & spline = frames.getSpline();
+	const std::size_t intervals = spline.isLoop() || count == 1 ? count : count - 1;
+	const float interval = spline.distance() / static_cast<float>(intervals);
+	result.resize(count);
+	for (std::size_t i = 0; i < count; i++) {
+		result[i] = interval * static_cast<float>(i);
+	}
+	return result;
+}
+
+// frames of count ties evenly spaced by arc length, a loop does not repeat its start
+inline std::vector<SplineFrame> getTieFrames(const SplineFrames & frames, const std::size_t count) {
+	const std::vector<float> distances = getTieDistances(frames, count);
+	std::vector<SplineFrame> result(distances.size());
+	if (!distances.empty()) {
+		frames.get(distances.data(), distances.size(), result.data());
+	}
+	return result;
+}
+
+// static geometry of one stretch of track with world positions and colors baked in, so that a stretch is drawn
+// in one call whatever it holds
+struct TrackChunk {
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> normals;
+	std::vector<glm::vec3> colors;
+	std::vector<unsigned int> indices;
+	// bounds of the positions
+	glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+	glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+	void push(const glm::vec3 & position, const glm::vec3 & normal, const glm::vec3 & color) {
+		positions.push_back(position);
+		normals.push_back(normal);
+		colors.push_back(color);
+		min = glm::min(min, position);
+		max = glm::max(max, position);
+	}
+
+	// appends a mesh transformed by model, normals are transformed the way the vertex shader does it
+	void add(const std::vector<glm::vec3> & meshPositions, const std::vector<glm::vec3> & meshNormals,
+	         const std::vector<unsigned int> & meshIndices, const glm::mat4 & model, const glm::vec3 & color) {
+		const auto first = static_cast<unsigned int>(positions.size());
+		const glm::mat3 rotation(model);
+		for (std::size_t i = 0; i < meshPositions.size(); i++) {
+			push(glm::vec3(model * glm::vec4(meshPositions[i], 1.0f)), rotation * meshNormals[i], color);
+		}
+		for (const unsigned int index : meshIndices) {
+			indices.push_back(first + index);
+		}
+	}
+
+	// both rails along the frames of points [first, last], one quad per line in between
+	void addRails(const SplineFrames & frames, const std::size_t first, const std::size_t last, const float trackWidth,
+	              const float railWidth, const glm::vec3 & color) {
+		const auto start = static_cast<unsigned int>(positions.size());
+		for (std::size_t k = first; k <= last; k++) {
+			const SplineFrame frame = frames[k];
+			push(frame.position - frame.right * trackWidth * railWidth, frame.up, color);
+			push(frame.position - frame.right * trackWidth, frame.up, color);
+			push(frame.position + frame.right * trackWidth, frame.up, color);
+			push(frame.position + frame.right * trackWidth * railWidth, frame.up, color);
+		}
+		// four vertices per point, the left rail comes first
+		for (unsigned int i = start; i + 4 < static_cast<unsigned int>(positions.size()); i += 4) {
+			for (const unsigned int side : { 0u, 2u }) {
+				indices.push_back(i + side);
+				indices.push_back(i + side + 1);
+				indices.push_back(i + side + 4);
+
+				indices.push_back(i + side + 1);
+				indices.push_back(i + side + 5);
+				indices.push_back(i + side + 4);
+			}
+		}
+	}
+
+	bool empty() const {
+		return indices.empty();
+	}
+
+	// bytes of the vertex and index data
+	std::size_t getSize() const {
+		return positions.size() * 3 * sizeof(glm::vec3) + indices.size() * sizeof(unsigned int);
+	}
+
+	// rails and ties of the stretch [from, to) of the track alone, so that a long track is built piece by piece:
+	// the rails cover every line starting in the stretch and the ties lie at multiples of tieSpacing, stretches
+	// that share a boundary share none of their ties
+	static TrackChunk buildRange(const SplineFrames & frames, const float from, const float to, const float trackWidth,
+	                             const float railWidth, const glm::vec3 & railColor, const float tieSpacing,
+	                             const std::vector<glm::vec3> & tiePositions,
+	                             const std::vector<glm::vec3> & tieNormals,
+	                             const std::vector<unsigned int> & tieIndices, const glm::vec3 & tieScale,
+	                             const glm::vec3 & tieColor) {
+		TrackChunk result;
+		const std::vector<float> & arcs = frames.getSpline().getDistances();
+		if (frames.size() < 2 || arcs.size() != frames.size()) {
+			return result;
+		}
+
+		// line k runs from point k to point k + 1
+		const auto first = static_cast<std::size_t>(std::lower_bound(arcs.begin(), arcs.end() - 1, from) - arcs.begin());
+		const auto last = static_cast<std::size_t>(std::lower_bound(arcs.begin(), arcs.end() - 1, to) - arcs.begin());
+		if (first < last) {
+			result.addRails(frames, first, last, trackWidth, railWidth, railColor);
+		}
+
+		// tie i lies at i * tieSpacing and the range of i is fixed once in integers, so that rounding never
+		// places a tie at the end of a loop on top of the one at its start
+		const auto getTie = [tieSpacing](const float distance) {
+			return static_cast<std::size_t>(glm::max(glm::ceil(distance / tieSpacing - 1e-4f), 0.0f));
+		};
+		const std::size_t firstTie = getTie(from);
+		const std::size_t lastTie = glm::min(getTie(to), getTie(frames.getSpline().distance()));
+		std::vector<float> distances;
+		for (std::size_t i = firstTie; i < lastTie; i++) {
+			distances.push_back(static_cast<float>(i) * tieSpacing);
+		}
+		std::vector<SplineFrame> ties(distances.size());
+		if (!distances.empty()) {
+			frames.get(distances.data(), distances.size(), ties.data());
+		}
+		for (const SplineFrame & tie : ties) {
+			const glm::mat4 model = glm::translate(glm::mat4(1.0f), tie.position) * glm::mat4_cast(tie.getRotation());
+			result.add(tiePositions, tieNormals, tieIndices, glm::scale(model, tieScale), tieColor);
+		}
+		return result;
+	}
+
+	// rails and count ties of the track split into stretches of chunkLength arc length: a quad of the rails goes
+	// to the stretch its first point lies on and a tie to the one its center lies on, ties are the tie mesh
+	// scaled and placed on the tie frames
+	static std::vector<TrackChunk> build(const SplineFrames & frames, const float chunkLength, const float trackWidth,
+	                                     const float railWidth, const glm::vec3 & railColor, const std::size_t count,
+	                                     const std::vector<glm::vec3> & tiePositions,
+	                                     const std::vector<glm::vec3> & tieNormals,
+	                                     const std::vector<unsigned int> & tieIndices, const glm::vec3 & tieScale,
+	                                     const glm::vec3 & tieColor) {
+		const Spline & spline = frames.getSpline();
+		const auto chunks = glm::max<std::size_t>(static_cast<std::size_t>(glm::ceil(spline.distance() / chunkLength)), 1);
+		std::vector<TrackChunk> result(chunks);
+		const auto getChunk = [&spline, chunkLength, chunks](const float distance) {
+			return glm::min(static_cast<std::size_t>(spline.wrap(distance) / chunkLength), chunks - 1);
+		};
+
+		// arc length at every point, rail vertex i belongs to point i / 2
+		const std::vector<float> & distances = spline.getDistances();
+
+		// both rails share their indices and every six of them form one quad, a chunk holds the left and right
+		// copy of each rail vertex it uses next to each other
+		const RailsGeometry rails = RailsGeometry::build(frames, trackWidth, railWidth);
+		std::vector<unsigned int> remap(rails.left.size());
+		std::vector<std::size_t> owners(rails.left.size(), chunks);
+		for (std::size_t quad = 0; quad + 6 <= rails.indices.size(); quad += 6) {
+			const std::size_t idx = getChunk(distances[rails.indices[quad] / 2]);
+			TrackChunk & chunk = result[idx];
+			for (std::size_t k = quad; k < quad + 6; k++) {
+				const unsigned int vertex = rails.indices[k];
+				if (owners[vertex] != idx) {
+					owners[vertex] = idx;
+					remap[vertex] = static_cast<unsigned int>(chunk.positions.size());
+					chunk.push(rails.left[vertex], rails.normals[vertex], railColor);
+					chunk.push(rails.right[vertex], rails.normals[vertex], railColor);
+				}
+			}
+			for (const unsigned int side : { 0u, 1u }) {
+				for (std::size_t k = quad; k < quad + 6; k++) {
+					chunk.indices.push_back(remap[rails.indices[k]] + side);
+				}
+			}
+		}
+
+		const std::vector<float> tieDistances = getTieDistances(frames, count);
+		const std::vector<SplineFrame> ties = getTieFrames(frames, count);
+		for (std::size_t i = 0; i < ties.size(); i++) {
+			const glm::mat4 model = glm::translate(glm::mat4(1.0f), ties[i].position) * glm::mat4_cast(ties[i].getRotation());
+			result[getChunk(tieDistances[i])].add(tiePositions, tieNormals, tieIndices, glm::scale(model, tieScale),
+			                                      tieColor);
+		}
+
+		// a short track leaves empty stretches
+		result.erase(std::remove_if(result.begin(), result.end(), [](const TrackChunk & chunk) {
+			return chunk.empty();
+		}), result.end());
+		return result;
+	}
+};
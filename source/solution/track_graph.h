@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "train_fleet.h"
+
+// network of directed tracks: every edge is a spline from one node to another and every node is a junction
+// with a switch, the edge a train takes after another one is looked up in a successor table built once,
+// so moving on to the next edge never searches
+class TrackGraph {
+public:
+	// an enumerator rather than a static member so that it may be passed by reference without a definition
+	enum : std::uint32_t { None = 0xffffffff };
+
+	TrackGraph() : m_isBuilt(false), m_revision(0), m_epoch(0), m_firstTrack(None) {}
+
+	TrackGraph(const TrackGraph &) = delete;
+	TrackGraph & operator=(const TrackGraph &) = delete;
+
+public:
+	std::uint32_t addNode() {
+		m_switches.push_back(0);
+		return static_cast<std::uint32_t>(m_switches.size() - 1);
+	}
+
+	// the spline runs from node from to node to, track that is used both ways needs an edge per direction
+	std::uint32_t addEdge(const std::uint32_t from, const std::uint32_t to, Spline spline) {
+		m_splines.push_back(std::move(spline));
+		m_edges.push_back({ from, to });
+		m_isBuilt = false;
+		return static_cast<std::uint32_t>(m_edges.size() - 1);
+	}
+
+	// a train leaving edge in may go on to edge out, once an edge has connections only those are used,
+	// otherwise every edge leaving its end node is an option, e.g. crossings connect only straight through
+	void connect(const std::uint32_t in, const std::uint32_t out) {
+		m_connections.push_back({ in, out });
+		m_isBuilt = false;
+	}
+
+	// builds the frames of every edge and the successor table, call it after the last edge and before addTo,
+	// a fleet holds pointers to the frames so the graph cannot be rebuilt once it is registered
+	void build(const glm::vec3 & up = { .0f, 1.0f, .0f }) {
+		assert(m_firstTrack == None && "the frames are registered with a fleet");
+		m_frames.clear();
+		for (const Spline & spline : m_splines) {
+			m_frames.emplace_back(spline, up);
+		}
+
+		const std::size_t n = m_edges.size();
+		std::vector<std::vector<std::uint32_t>> options(n);
+		for (const Edge & connection : m_connections) {
+			options[connection.from].push_back(connection.to);
+		}
+		std::vector<std::vector<std::uint32_t>> leaving(m_switches.size());
+		for (std::size_t i = 0; i < n; i++) {
+			leaving[m_edges[i].from].push_back(static_cast<std::uint32_t>(i));
+		}
+		m_nodeOffsets.assign(1, 0);
+		m_leaving.clear();
+		for (const auto & edges : leaving) {
+			m_leaving.insert(m_leaving.end(), edges.begin(), edges.end());
+			m_nodeOffsets.push_back(static_cast<std::uint32_t>(m_leaving.size()));
+		}
+
+		m_offsets.assign(1, 0);
+		m_successors.clear();
+		for (std::size_t i = 0; i < n; i++) {
+			const std::vector<std::uint32_t> & successors = options[i].empty() ? leaving[m_edges[i].to] : options[i];
+			m_successors.insert(m_successors.end(), successors.begin(), successors.end());
+			m_offsets.push_back(static_cast<std::uint32_t>(m_successors.size()));
+		}
+		m_isBuilt = true;
+		m_revision++;
+		m_epoch++;
+	}
+
+public:
+	// position of the switch of a node, it selects the option of every edge ending there, wrapped by their count
+	void setSwitch(const std::uint32_t node, const std::uint32_t position) {
+		if (m_switches[node] != position) {
+			m_switches[node] = position;
+			m_epoch++;
+		}
+	}
+
+	std::uint32_t getSwitch(const std::uint32_t node) const {
+		return m_switches[node];
+	}
+
+	// edge a train takes after the given one with the switches as they are, None at a dead end
+	std::uint32_t getNext(const std::uint32_t edge) const {
+		const std::uint32_t first = m_offsets[edge];
+		const std::uint32_t count = m_offsets[edge + 1] - first;
+		if (count == 0) {
+			return None;
+		}
+		return m_successors[first + m_switches[m_edges[edge].to] % count];
+	}
+
+	// number of edges a train may take after the given one
+	std::uint32_t getOptionCount(const std::uint32_t edge) const {
+		return m_offsets[edge + 1] - m_offsets[edge];
+	}
+
+	std::uint32_t getOption(const std::uint32_t edge, const std::uint32_t index) const {
+		return m_successors[m_offsets[edge] + index];
+	}
+
+	// number of edges starting at a node, valid after build
+	std::uint32_t getLeavingCount(const std::uint32_t node) const {
+		return m_nodeOffsets[node + 1] - m_nodeOffsets[node];
+	}
+
+	std::uint32_t getLeaving(const std::uint32_t node, const std::uint32_t index) const {
+		return m_leaving[m_nodeOffsets[node] + index];
+	}
+
+public:
+	// registers every edge as a track of the fleet once, cars only stop at the end of dead ends
+	void addTo(TrainFleet & fleet) {
+		assert(m_isBuilt && m_firstTrack == None && "build first and register with one fleet only");
+		for (std::size_t i = 0; i < m_frames.size(); i++) {
+			const std::uint32_t track = fleet.addTrack(m_frames[i], getOptionCount(static_cast<std::uint32_t>(i)) == 0);
+			if (i == 0) {
+				m_firstTrack = track;
+			}
+		}
+	}
+
+	std::size_t addCar(TrainFleet & fleet, const std::uint32_t edge, const float distance, const float speed,
+	                   const float offset = 0.0f) const {
+		return fleet.addCar(m_firstTrack + edge, distance, speed, offset);
+	}
+
+	// moves every car whose own position, its distance less its offset behind the head, ran past the end of its
+	// edge on to the next one, so the cars of a train follow the head over a junction one by one, and gives every
+	// car the authority up to a dead end its head is about to run into: a car still on the edge before the
+	// junction then brakes for the buffer stop along with the head instead of running into the car ahead,
+	// the graph owns the authorities of the cars on its edges, call it after every fleet update, switches are
+	// not locked, keeping them from changing under a train is up to the caller
+	void update(TrainFleet & fleet) const {
+		const std::vector<float> & distances = fleet.getDistances();
+		const std::vector<float> & velocities = fleet.getVelocities();
+		const std::vector<float> & offsets = fleet.getOffsets();
+		const std::vector<std::uint32_t> & tracks = fleet.getTrackIds();
+		const float braking = fleet.getBraking();
+		for (std::size_t i = 0; i < fleet.size(); i++) {
+			if (tracks[i] < m_firstTrack || tracks[i] - m_firstTrack >= m_edges.size()) {
+				continue;
+			}
+			// a car moves less than an edge per tick, the loop only guards against very short edges
+			std::uint32_t edge = tracks[i] - m_firstTrack;
+			while (distances[i] - offsets[i] >= m_splines[edge].distance()) {
+				const std::uint32_t next = getNext(edge);
+				if (next == None) {
+					break;
+				}
+				fleet.setTrack(i, m_firstTrack + next, distances[i] - m_splines[edge].distance());
+				edge = next;
+			}
+
+			// the head runs up to the length of the train ahead of the car, on the edges the car will take
+			float head = distances[i];
+			std::uint32_t ahead = edge;
+			while (head >= m_splines[ahead].distance()) {
+				const std::uint32_t next = getNext(ahead);
+				if (next == None) {
+					break;
+				}
+				head -= m_splines[ahead].distance();
+				ahead = next;
+			}
+
+			// a dead end counts once it is within the braking distance and a second of travel of the head
+			const float reach = velocities[i] * velocities[i] / (2.0f * braking) + velocities[i] + 1.0f;
+			float end = m_splines[ahead].distance() - head;
+			std::uint32_t next = getNext(ahead);
+			while (end < reach && next != None) {
+				end += m_splines[next].distance();
+				next = getNext(next);
+			}
+			fleet.setAuthority(i, end < reach ? end : std::numeric_limits<float>::max());
+		}
+	}
+
+public:
+	std::size_t getNodeCount() const {
+		return m_switches.size();
+	}
+
+	std::size_t getEdgeCount() const {
+		return m_edges.size();
+	}
+
+	std::uint32_t getFrom(const std::uint32_t edge) const {
+		return m_edges[edge].from;
+	}
+
+	std::uint32_t getTo(const std::uint32_t edge) const {
+		return m_edges[edge].to;
+	}
+
+	const Spline & getSpline(const std::uint32_t edge) const {
+		return m_splines[edge];
+	}
+
+	// valid after build
+	const SplineFrames & getFrames(const std::uint32_t edge) const {
+		return m_frames[edge];
+	}
+
+	// fleet track of the edge, valid after addTo
+	std::uint32_t getTrack(const std::uint32_t edge) const {
+		return m_firstTrack + edge;
+	}
+
+	bool isBuilt() const {
+		return m_isBuilt;
+	}
+
+	// changes with every build, results that only depend on the network are valid within a revision
+	std::uint64_t getRevision() const {
+		return m_revision;
+	}
+
+	// changes with every build and every switch that moves, results that depend on the switches as well
+	// are valid within an epoch
+	std::uint64_t getEpoch() const {
+		return m_epoch;
+	}
+
+private:
+	struct Edge {
+		std::uint32_t from;
+		std::uint32_t to;
+	};
+
+	// deques keep the splines and frames in place, the frames point at their spline and the fleet at the frames
+	std::deque<Spline> m_splines;
+	std::deque<SplineFrames> m_frames;
+	std::vector<Edge> m_edges;
+	std::vector<Edge> m_connections;
+	std::vector<std::uint32_t> m_switches;
+	bool m_isBuilt;
+	std::uint64_t m_revision;
+	std::uint64_t m_epoch;
+
+private:
+	// successors of edge e are m_successors[m_offsets[e], m_offsets[e + 1])
+	std::vector<std::uint32_t> m_offsets;
+	std::vector<std::uint32_t> m_successors;
+	// edges starting at node n are m_leaving[m_nodeOffsets[n], m_nodeOffsets[n + 1])
+	std::vector<std::uint32_t> m_nodeOffsets;
+	std::vector<std::uint32_t> m_leaving;
+	std::uint32_t m_firstTrack;
+};
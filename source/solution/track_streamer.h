@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "framework/engine.h"
+#include "track_geometry.h"
+
+// rails and ties of a long track kept resident only around a few points of interest: chunks of chunkLength arc
+// length are generated on a worker thread as the points approach them, uploaded by the main thread within a time
+// slice per frame and evicted least recently used first once the resident ones exceed the memory budget,
+// the frames must not change while the streamer lives
+class TrackStreamer {
+public:
+	TrackStreamer(const SplineFrames & frames, const float chunkLength, const float tieSpacing, const float tieWidth,
+	              const float trackWidth, const float railWidth, const float radius, const std::size_t memoryBudget,
+	              const float uploadSlice = 0.002f, const glm::vec3 & railColor = { 0.15f, 0.15f, 0.15f })
+		: m_frames(&frames), m_chunkLength(chunkLength), m_tieSpacing(tieSpacing), m_tieWidth(tieWidth),
+		  m_trackWidth(trackWidth), m_railWidth(railWidth), m_railColor(railColor), m_radius(radius),
+		  m_memoryBudget(memoryBudget), m_uploadSlice(uploadSlice), m_memory(0), m_frame(0), m_isDone(false),
+		  m_inFlight(None) {
+		const float distance = frames.getSpline().distance();
+		m_chunkCount = glm::max<std::size_t>(static_cast<std::size_t>(glm::ceil(distance / chunkLength)), 1);
+
+		const Mesh tieMesh = createCube();
+		for (const Vertex & vertex : tieMesh.getVertices()) {
+			m_tiePositions.push_back(vertex.position);
+			m_tieNormals.push_back(vertex.normal);
+		}
+		m_tieIndices = tieMesh.getIndices();
+
+		m_worker = std::thread([this]() {
+			work();
+		});
+	}
+
+	~TrackStreamer() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isDone = true;
+		}
+		m_wake.notify_one();
+		m_worker.join();
+		for (const Resident & resident : m_residents) {
+			Engine::get()->deleteChunk(resident.chunk);
+		}
+	}
+
+	TrackStreamer(const TrackStreamer &) = delete;
+	TrackStreamer & operator=(const TrackStreamer &) = delete;
+
+public:
+	// call it once per frame with the arc lengths of the points of interest, e.g. the closest point to the camera
+	// and the lead train: requests the chunks within the radius of any of them closest first, uploads what the
+	// worker finished until the time slice runs out and evicts chunks not needed this frame over the budget
+	void update(const std::vector<float> & focus) {
+		m_frame++;
+		const std::vector<std::size_t> wanted = getWanted(focus);
+		for (const std::size_t chunk : wanted) {
+			const auto it = m_lookup.find(chunk);
+			if (it != m_lookup.end()) {
+				it->second->frame = m_frame;
+				m_residents.splice(m_residents.begin(), m_residents, it->second);
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (auto & ready : m_ready) {
+				m_uploads.push_back(std::move(ready));
+			}
+			m_ready.clear();
+
+			// chunks that are no longer wanted are dropped from the queue, the worker builds the rest in order
+			m_requests.clear();
+			for (const std::size_t chunk : wanted) {
+				if (m_lookup.count(chunk) == 0 && chunk != m_inFlight && !isUploading(chunk)) {
+					m_requests.push_back(chunk);
+				}
+			}
+		}
+		m_wake.notify_one();
+
+		upload(wanted);
+		evict();
+	}
+
+public:
+	std::size_t getChunkCount() const {
+		return m_chunkCount;
+	}
+
+	std::size_t getResidentCount() const {
+		return m_residents.size();
+	}
+
+	// bytes of the resident chunks
+	std::size_t getMemory() const {
+		return m_memory;
+	}
+
+	// chunks built by the worker and waiting for their upload
+	std::size_t getUploadCount() const {
+		return m_uploads.size();
+	}
+
+	bool isResident(const std::size_t chunk) const {
+		return m_lookup.count(chunk) != 0;
+	}
+
+private:
+	enum : std::size_t { None = static_cast<std::size_t>(-1) };
+
+	struct Resident {
+		std::size_t index;
+		StaticChunk * chunk;
+		std::size_t size;
+		// last frame it was wanted in
+		std::uint64_t frame;
+	};
+
+	// chunks within the radius of the focus points, closest first and each once
+	std::vector<std::size_t> getWanted(const std::vector<float> & focus) const {
+		const Spline & spline = m_frames->getSpline();
+		const auto count = static_cast<std::ptrdiff_t>(m_chunkCount);
+		const auto reach = static_cast<std::ptrdiff_t>(glm::ceil(m_radius / m_chunkLength));
+		std::vector<std::pair<std::ptrdiff_t, std::size_t>> candidates;
+		for (const float distance : focus) {
+			const auto center = static_cast<std::ptrdiff_t>(spline.wrap(distance) / m_chunkLength);
+			for (std::ptrdiff_t offset = -reach; offset <= reach; offset++) {
+				std::ptrdiff_t chunk = center + offset;
+				if (spline.isLoop()) {
+					chunk = (chunk % count + count) % count;
+				} else if (chunk < 0 || chunk >= count) {
+					continue;
+				}
+				candidates.emplace_back(std::abs(offset), static_cast<std::size_t>(chunk));
+			}
+		}
+		std::sort(candidates.begin(), candidates.end());
+
+		std::vector<std::size_t> result;
+		for (const auto & candidate : candidates) {
+			if (std::find(result.begin(), result.end(), candidate.second) == result.end()) {
+				result.push_back(candidate.second);
+			}
+		}
+		return result;
+	}
+
+	bool isUploading(const std::size_t chunk) const {
+		return std::find_if(m_uploads.begin(), m_uploads.end(), [chunk](const std::pair<std::size_t, TrackChunk> & upload) {
+			return upload.first == chunk;
+		}) != m_uploads.end();
+	}
+
+	// uploads finished chunks until the time slice runs out, at least one per frame so that uploads never stall
+	void upload(const std::vector<std::size_t> & wanted) {
+		const auto start = std::chrono::steady_clock::now();
+		bool isUploaded = false;
+		while (!m_uploads.empty()) {
+			if (isUploaded &&
+			    std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= m_uploadSlice) {
+				break;
+			}
+			std::pair<std::size_t, TrackChunk> ready = std::move(m_uploads.front());
+			m_uploads.pop_front();
+			// the points of interest may have moved on while it was built
+			if (m_lookup.count(ready.first) != 0 ||
+			    std::find(wanted.begin(), wanted.end(), ready.first) == wanted.end()) {
+				continue;
+			}
+
+			const TrackChunk & geometry = ready.second;
+			std::vector<StaticVertex> vertices(geometry.positions.size());
+			for (std::size_t i = 0; i < vertices.size(); i++) {
+				vertices[i] = { geometry.positions[i], geometry.normals[i], geometry.colors[i] };
+			}
+			StaticChunk * chunk = Engine::get()->createChunk();
+			chunk->set(vertices, geometry.indices);
+
+			m_residents.push_front({ ready.first, chunk, geometry.getSize(), m_frame });
+			m_lookup[ready.first] = m_residents.begin();
+			m_memory += geometry.getSize();
+			isUploaded = true;
+		}
+	}
+
+	// least recently wanted chunks go first, chunks wanted this frame stay even over the budget
+	void evict() {
+		while (m_memory > m_memoryBudget && !m_residents.empty() && m_residents.back().frame != m_frame) {
+			const Resident & resident = m_residents.back();
+			Engine::get()->deleteChunk(resident.chunk);
+			m_memory -= resident.size;
+			m_lookup.erase(resident.index);
+			m_residents.pop_back();
+		}
+	}
+
+	void work() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true) {
+			m_wake.wait(lock, [this]() {
+				return m_isDone || !m_requests.empty();
+			});
+			if (m_isDone) {
+				return;
+			}
+			m_inFlight = m_requests.front();
+			m_requests.pop_front();
+
+			// the geometry is built without the lock, it only reads the frames
+			const std::size_t index = m_inFlight;
+			lock.unlock();
+			// the end is computed the way the next chunk computes its start, so that they agree on the shared ties
+			const float from = static_cast<float>(index) * m_chunkLength;
+			const float to = static_cast<float>(index + 1) * m_chunkLength;
+			TrackChunk chunk = TrackChunk::buildRange(*m_frames, from, to, m_trackWidth, m_railWidth,
+			                                          m_railColor, m_tieSpacing, m_tiePositions, m_tieNormals,
+			                                          m_tieIndices, { m_tieWidth, 0.0f, 0.1f }, { 1.0f, 0.8f, 0.1f });
+			lock.lock();
+			m_ready.emplace_back(index, std::move(chunk));
+			m_inFlight = None;
+		}
+	}
+
+private:
+	const SplineFrames * m_frames;
+	float m_chunkLength;
+	float m_tieSpacing;
+	float m_tieWidth;
+	float m_trackWidth;
+	float m_railWidth;
+	glm::vec3 m_railColor;
+	float m_radius;
+	std::size_t m_memoryBudget;
+	float m_uploadSlice;
+	std::size_t m_chunkCount;
+	std::vector<glm::vec3> m_tiePositions;
+	std::vector<glm::vec3> m_tieNormals;
+	std::vector<unsigned int> m_tieIndices;
+
+private:
+	// main thread only, the most recently wanted chunk comes first
+	std::list<Resident> m_residents;
+	std::unordered_map<std::size_t, std::list<Resident>::iterator> m_lookup;
+	std::deque<std::pair<std::size_t, TrackChunk>> m_uploads;
+	std::size_t m_memory;
+	std::uint64_t m_frame;
+
+private:
+	// shared with the worker under the mutex
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_isDone;
+	std::deque<std::size_t> m_requests;
+	std::vector<std::pair<std::size_t, TrackChunk>> m_ready;
+	std::size_t m_inFlight;
+	std::thread m_worker;
+};
@@ -1,38 +1,62 @@
 #pragma once
 
 #include "framework/engine.h"
+#include "spline_frames.h"
 
+// car moving along the arc length of a track, speeds are in units per second and limits in units per second squared
 class Train {
 public:
-	explicit Train(Mesh & mesh, const glm::vec3 & start = glm::vec3(0.0f), const float speed = 0.1f)
-		: m_object(nullptr), m_speed(speed), m_idx(0) {
+	explicit Train(Mesh & mesh, const float distance = 0.0f, const float speed = 1.0f,
+	               const float acceleration = 0.5f, const float braking = 1.0f)
+		: m_object(nullptr), m_speed(speed), m_acceleration(acceleration), m_braking(braking),
+		  m_distance(distance), m_previous(distance), m_velocity(0.0f) {
 		m_object = Engine::get()->createObject(&mesh);
-		m_object->setPosition(start);
 		m_object->setColor(0.2f, 0.0f, 0.0f);
 		m_object->setScale(0.5f, 0.5f, 1.0f);
 	}
 
 public:
-	void tutuuu(const std::vector<glm::vec3> & path) {
-		if (!path.empty() && translate(path[m_idx])) {
-			if (m_idx < path.size() - 1) {
-				++m_idx;
-			} else {
-				m_idx = 0;
+	// advances by dt seconds and moves the object there, the cost follows the frame rate
+	void tutuuu(const SplineFrames & frames, const float dt) {
+		step(frames.getSpline(), dt);
+		render(frames);
+	}
+
+	// advances the simulation only, used with a fixed timestep
+	void step(const Spline & spline, const float dt) {
+		const float total = spline.distance();
+		float speed = m_speed;
+		if (!spline.isLoop()) {
+			// brake in time to stop at the end of the track, looking one step ahead
+			const float remaining = glm::max(total - m_distance - m_velocity * dt, 0.0f);
+			speed = glm::min(speed, glm::sqrt(2.0f * m_braking * remaining));
+		}
+
+		if (m_velocity < speed) {
+			m_velocity = glm::min(m_velocity + m_acceleration * dt, speed);
+		} else {
+			m_velocity = glm::max(m_velocity - m_braking * dt, speed);
+		}
+
+		m_previous = m_distance;
+		m_distance += m_velocity * dt;
+		if (spline.isLoop()) {
+			// keep both positions small so that they do not lose precision over time
+			if (total > 0.0f && m_distance >= total) {
+				m_distance -= total;
+				m_previous -= total;
 			}
+		} else if (m_distance >= total) {
+			m_distance = total;
+			m_velocity = 0.0f;
 		}
 	}
 
-private:
-	bool translate(const glm::vec3 & to) const {
-		if ((distance(m_object->getPosition(), to)) >= m_speed) {
-			const glm::vec3 position = m_object->getPosition();
-			const glm::vec3 forward = normalize(to - position);
-			m_object->setPosition(position + forward * m_speed);
-			m_object->setRotation(quatLookAt(forward, { 0.0f, 1.0f, 0.0f }));
-			return false;
-		}
-		return true;
+	// places the object alpha of the way from the previous step to the current one
+	void render(const SplineFrames & frames, const float alpha = 1.0f) const {
+		const SplineFrame frame = frames.get(getDistance(alpha));
+		m_object->setPosition(frame.position);
+		m_object->setRotation(frame.getRotation());
 	}
 
 public:
@@ -44,10 +68,67 @@ public:
 		return m_speed;
 	}
 
+	// speed the train accelerates or brakes towards
+	void setSpeed(const float speed) {
+		m_speed = speed;
+	}
+
+	float getVelocity() const {
+		return m_velocity;
+	}
+
+	float getDistance() const {
+		return m_distance;
+	}
+
+	// arc length alpha of the way from the previous step to the current one
+	float getDistance(const float alpha) const {
+		return glm::mix(m_previous, m_distance, alpha);
+	}
+
 private:
 	Object * m_object;
 	float m_speed;
+	float m_acceleration;
+	float m_braking;
+
+private:
+	// arc length after the last step and before it
+	float m_distance;
+	float m_previous;
+	float m_velocity;
+};
+
+// splits frame times into fixed simulation steps, the remainder carries over to the next frame
+class FixedTimestep {
+public:
+	explicit FixedTimestep(const float step = 1.0f / 60.0f, const std::size_t maxSteps = 8)
+		: m_step(step), m_maxSteps(maxSteps), m_accumulator(0.0f) {}
+
+public:
+	// number of steps to simulate for a frame of dt seconds, time beyond maxSteps is dropped
+	std::size_t advance(const float dt) {
+		m_accumulator += dt;
+		const auto steps = static_cast<std::size_t>(m_accumulator / m_step);
+		if (steps > m_maxSteps) {
+			m_accumulator = 0.0f;
+			return m_maxSteps;
+		}
+		m_accumulator -= static_cast<float>(steps) * m_step;
+		return steps;
+	}
+
+	// how far the frame is between the last two steps, used to interpolate rendering
+	float getAlpha() const {
+		return glm::clamp(m_accumulator / m_step, 0.0f, 1.0f);
+	}
+
+	float getStep() const {
+		return m_step;
+	}
 
 private:
-	std::size_t m_idx;
+	float m_step;
+	std::size_t m_maxSteps;
+	float m_accumulator;
 };
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "job_system.h"
+#include "spline_frames.h"
+
+// kinematic state of every car of every train in structure-of-arrays form, independent of the engine,
+// speeds are in units per second and limits in units per second squared
+class TrainFleet {
+public:
+	// fixed-point steps per unit of arc length
+	static constexpr double FixedPointScale = 65536.0;
+
+	explicit TrainFleet(const float acceleration = 0.5f, const float braking = 1.0f,
+	                    const glm::vec3 & scale = { 0.5f, 0.5f, 1.0f })
+		: m_acceleration(acceleration), m_braking(braking), m_scale(scale), m_isFixedPoint(false) {}
+
+public:
+	// the frames must outlive the fleet, returns the track id, cars brake to stop at the end of an open track
+	// unless something else moves them on to the next track, see setTrack
+	std::uint32_t addTrack(const SplineFrames & frames, const bool isStopAtEnd = true) {
+		m_tracks.push_back(&frames);
+		m_trackStops.push_back(isStopAtEnd && !frames.getSpline().isLoop() ? 1.0f : 0.0f);
+		return static_cast<std::uint32_t>(m_tracks.size() - 1);
+	}
+
+	// car whose train head is at distance along the track and which trails it by offset, returns the car id
+	std::size_t addCar(const std::uint32_t track, const float distance, const float speed, const float offset = 0.0f) {
+		m_distances.push_back(0.0f);
+		m_fixedDistances.push_back(0);
+		m_velocities.push_back(0.0f);
+		m_speeds.push_back(speed);
+		m_authorities.push_back(std::numeric_limits<float>::max());
+		m_lengths.push_back(0.0f);
+		m_loops.push_back(0.0f);
+		m_stops.push_back(0.0f);
+		m_trackIds.push_back(0);
+		m_offsets.push_back(offset);
+		m_transforms.emplace_back(1.0f);
+		setTrack(m_distances.size() - 1, track, distance);
+		return m_distances.size() - 1;
+	}
+
+	// moves the car onto another track at distance along it, keeping its velocity
+	void setTrack(const std::size_t car, const std::uint32_t track, const float distance) {
+		const Spline & spline = m_tracks[track]->getSpline();
+		m_distances[car] = distance;
+		m_fixedDistances[car] = toFixed(distance);
+		m_lengths[car] = spline.distance();
+		m_loops[car] = spline.isLoop() ? 1.0f : 0.0f;
+		m_stops[car] = m_trackStops[track];
+		m_trackIds[car] = track;
+	}
+
+	void reserve(const std::size_t size) {
+		m_distances.reserve(size);
+		m_fixedDistances.reserve(size);
+		m_velocities.reserve(size);
+		m_speeds.reserve(size);
+		m_authorities.reserve(size);
+		m_lengths.reserve(size);
+		m_loops.reserve(size);
+		m_stops.reserve(size);
+		m_trackIds.reserve(size);
+		m_offsets.reserve(size);
+		m_transforms.reserve(size);
+	}
+
+	void setSpeed(const std::size_t car, const float speed) {
+		m_speeds[car] = speed;
+	}
+
+	// arc length the car may still travel before it has to stand, the car brakes to stop within it
+	void setAuthority(const std::size_t car, const float authority) {
+		m_authorities[car] = authority;
+	}
+
+	// accumulates arc lengths as integers of FixedPointScale steps per unit, so that they never drift
+	// by rounding and replay the same on any compiler
+	void setFixedPoint(const bool isFixedPoint) {
+		m_isFixedPoint = isFixedPoint;
+		for (std::size_t i = 0; i < m_distances.size(); i++) {
+			m_fixedDistances[i] = toFixed(m_distances[i]);
+			m_distances[i] = fromFixed(m_fixedDistances[i]);
+		}
+	}
+
+	bool isFixedPoint() const {
+		return m_isFixedPoint;
+	}
+
+	// FNV-1a over the arc length and velocity of every car in order, equal states give equal hashes
+	std::uint64_t getStateHash() const {
+		std::uint64_t hash = 14695981039346656037ull;
+		const auto combine = [&hash](const void * data, const std::size_t size) {
+			const auto * bytes = static_cast<const unsigned char *>(data);
+			for (std::size_t i = 0; i < size; i++) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		};
+		if (m_isFixedPoint) {
+			combine(m_fixedDistances.data(), m_fixedDistances.size() * sizeof(std::int64_t));
+		} else {
+			combine(m_distances.data(), m_distances.size() * sizeof(float));
+		}
+		combine(m_velocities.data(), m_velocities.size() * sizeof(float));
+		return hash;
+	}
+
+public:
+	// advances every car by dt seconds in one branch-free loop over flat arrays
+	void update(const float dt) {
+		integrate(0, m_distances.size(), dt);
+	}
+
+	// writes the model matrix of every car into the contiguous transform buffer
+	void updateTransforms() {
+		transform(0, m_distances.size());
+	}
+
+	// both of the above split into chunks of grain cars across the workers, the transforms are ready on return
+	void update(const float dt, JobSystem & jobs, const std::size_t grain = 1024) {
+		jobs.parallelFor(m_distances.size(), grain, [this, dt](const std::size_t first, const std::size_t last) {
+			integrate(first, last, dt);
+			transform(first, last);
+		});
+	}
+
+public:
+	std::size_t size() const noexcept {
+		return m_distances.size();
+	}
+
+	bool empty() const noexcept {
+		return m_distances.empty();
+	}
+
+	const std::vector<float> & getDistances() const {
+		return m_distances;
+	}
+
+	const std::vector<float> & getVelocities() const {
+		return m_velocities;
+	}
+
+	const std::vector<float> & getAuthorities() const {
+		return m_authorities;
+	}
+
+	float getBraking() const {
+		return m_braking;
+	}
+
+	const std::vector<std::uint32_t> & getTrackIds() const {
+		return m_trackIds;
+	}
+
+	const std::vector<float> & getOffsets() const {
+		return m_offsets;
+	}
+
+	// one model matrix per car, refreshed by updateTransforms
+	const std::vector<glm::mat4> & getTransforms() const {
+		return m_transforms;
+	}
+
+private:
+	void integrate(const std::size_t first, const std::size_t last, const float dt) {
+		if (m_isFixedPoint) {
+			integrateFixed(first, last, dt);
+			return;
+		}
+
+		integrate(last - first, m_distances.data() + first, m_velocities.data() + first, m_authorities.data() + first,
+		          m_speeds.data() + first, m_lengths.data() + first, m_loops.data() + first, m_stops.data() + first,
+		          m_acceleration, m_braking, dt);
+	}
+
+	// the arrays never overlap, restrict lets the loop vectorize without runtime overlap checks
+	static void integrate(const std::size_t n, float * __restrict distances, float * __restrict velocities,
+	                      float * __restrict authorities, const float * __restrict speeds,
+	                      const float * __restrict lengths, const float * __restrict loops,
+	                      const float * __restrict stops, const float acceleration, const float braking, const float dt) {
+		const float unlimited = std::numeric_limits<float>::max();
+		for (std::size_t i = 0; i < n; i++) {
+			const float velocity = accelerate(distances[i], velocities[i], speeds[i], lengths[i], stops[i], authorities[i],
+			                                  acceleration, braking, dt);
+			const float distance = distances[i] + velocity * dt;
+			const float wrapped = distance >= lengths[i] ? loops[i] * lengths[i] : 0.0f;
+			distances[i] = glm::min(distance - wrapped, lengths[i] + (1.0f - stops[i]) * unlimited);
+			velocities[i] = velocity;
+			authorities[i] -= velocity * dt;
+		}
+	}
+
+	// same as integrate with the arc length kept in fixed point
+	void integrateFixed(const std::size_t first, const std::size_t last, const float dt) {
+		for (std::size_t i = first; i < last; i++) {
+			const float velocity = accelerate(m_distances[i], m_velocities[i], m_speeds[i], m_lengths[i], m_stops[i],
+			                                  m_authorities[i], m_acceleration, m_braking, dt);
+			const std::int64_t length = toFixed(m_lengths[i]);
+			std::int64_t distance = m_fixedDistances[i] + toFixed(velocity * dt);
+			if (distance >= length && m_loops[i] > 0.0f) {
+				distance -= length;
+			} else if (distance >= length && m_stops[i] > 0.0f) {
+				distance = length;
+			}
+			m_fixedDistances[i] = distance;
+			m_distances[i] = fromFixed(distance);
+			m_velocities[i] = velocity;
+			m_authorities[i] -= velocity * dt;
+		}
+	}
+
+	// velocity of a car after dt seconds of accelerating or braking towards its speed
+	static float accelerate(const float distance, const float velocity, const float speed, const float length,
+	                        const float stop, const float authority, const float acceleration, const float braking,
+	                        const float dt) {
+		// brake in time to stop at the end of an open track and at the end of the authority
+		const float end = stop * (length - distance) + (1.0f - stop) * std::numeric_limits<float>::max();
+		const float remaining = glm::max(glm::min(end, authority) - velocity * dt, 0.0f);
+		const float target = glm::min(speed, glm::sqrt(2.0f * braking * remaining));
+		return glm::min(glm::max(target, velocity - braking * dt), velocity + acceleration * dt);
+	}
+
+	void transform(const std::size_t first, const std::size_t last) {
+		for (std::size_t i = first; i < last; i++) {
+			const SplineFrame frame = m_tracks[m_trackIds[i]]->get(m_distances[i] - m_offsets[i]);
+			const glm::mat4 rotation = glm::mat4_cast(frame.getRotation());
+			m_transforms[i] = glm::scale(glm::translate(glm::mat4(1.0f), frame.position) * rotation, m_scale);
+		}
+	}
+
+	static std::int64_t toFixed(const float distance) {
+		return static_cast<std::int64_t>(std::llround(static_cast<double>(distance) * FixedPointScale));
+	}
+
+	static float fromFixed(const std::int64_t distance) {
+		return static_cast<float>(static_cast<double>(distance) / FixedPointScale);
+	}
+
+private:
+	std::vector<const SplineFrames *> m_tracks;
+	// 1 for tracks the cars stop at the end of
+	std::vector<float> m_trackStops;
+	float m_acceleration;
+	float m_braking;
+	glm::vec3 m_scale;
+	bool m_isFixedPoint;
+
+private:
+	// one entry per car, the distance is the one of its train head
+	std::vector<float> m_distances;
+	// used instead of the distances in fixed-point mode, they then only mirror it
+	std::vector<std::int64_t> m_fixedDistances;
+	std::vector<float> m_velocities;
+	std::vector<float> m_speeds;
+	std::vector<float> m_authorities;
+	// length of the track, 1 for loops and 1 for tracks to stop at the end of, copied from the track
+	// so that the update never leaves the arrays
+	std::vector<float> m_lengths;
+	std::vector<float> m_loops;
+	std::vector<float> m_stops;
+	std::vector<std::uint32_t> m_trackIds;
+	std::vector<float> m_offsets;
+	std::vector<glm::mat4> m_transforms;
+};
@@ -2,16 +2,20 @@
 
 #include <vector>
 #include "framework/engine.h"
+#include "track_geometry.h"
+
+// ties share one instanced batch and are drawn in a single call
+static void addTie(const glm::vec3 & position, const glm::quat & rotation, const float width) {
+	static Mesh planeMesh = createCube();
+	static InstancedBatch * batch = Engine::get()->createBatch(&planeMesh);
+	const glm::mat4 model = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
+	batch->add(glm::scale(model, { width, 0.0f, 0.1f }), { 1.0f, 0.8f, 0.1f });
+}
 
 static void generateTies(const std::vector<glm::vec3> & points, const float width = 1.0f) {
-	auto createTie = [&points, width](const glm::vec3 & position, const glm::vec3 & lookAt) {
+	auto createTie = [width](const glm::vec3 & position, const glm::vec3 & lookAt) {
 		const glm::vec3 forward = normalize(lookAt - position);
-		static Mesh planeMesh = createCube();
-		Object * plane = Engine::get()->createObject(&planeMesh);
-		plane->setColor(1.0f, 0.8f, 0.1f);
-		plane->setScale(width, 0.0f, 0.1f);
-		plane->setPosition(position);
-		plane->setRotation(quatLookAt(forward, { 0.0f, 1.0f, 0.0f }));
+		addTie(position, quatLookAt(forward, { 0.0f, 1.0f, 0.0f }), width);
 	};
 
 	for (std::size_t i = 0; i < points.size() - 1; i++) {
@@ -22,3 +26,34 @@ static void generateTies(const std::vector<glm::vec3> & points, const float widt
 		createTie(points[points.size() - 1], points[points.size() - 2]);
 	}
 }
+
+// count ties evenly spaced by arc length and oriented by the frames of the track, a loop does not repeat its start
+static void generateTies(const SplineFrames & frames, const std::size_t count, const float width = 1.0f) {
+	for (const auto & frame : getTieFrames(frames, count)) {
+		addTie(frame.position, frame.getRotation(), width);
+	}
+}
+
+// rails and count ties merged into chunks of chunkLength arc length, each drawn in a single call
+static void generateStaticTrack(const SplineFrames & frames, const std::size_t count, const float tieWidth,
+                                const float trackWidth, const float railWidth, const float chunkLength,
+                                const glm::vec3 & railColor = { 0.15f, 0.15f, 0.15f }) {
+	const Mesh tieMesh = createCube();
+	std::vector<glm::vec3> tiePositions;
+	std::vector<glm::vec3> tieNormals;
+	for (const Vertex & vertex : tieMesh.getVertices()) {
+		tiePositions.push_back(vertex.position);
+		tieNormals.push_back(vertex.normal);
+	}
+
+	const std::vector<TrackChunk> chunks =
+		TrackChunk::build(frames, chunkLength, trackWidth, railWidth, railColor, count, tiePositions, tieNormals,
+		                  tieMesh.getIndices(), { tieWidth, 0.0f, 0.1f }, { 1.0f, 0.8f, 0.1f });
+	for (const TrackChunk & chunk : chunks) {
+		std::vector<StaticVertex> vertices(chunk.positions.size());
+		for (std::size_t i = 0; i < vertices.size(); i++) {
+			vertices[i] = { chunk.positions[i], chunk.normals[i], chunk.colors[i] };
+		}
+		Engine::get()->createChunk()->set(vertices, chunk.indices);
+	}
+}
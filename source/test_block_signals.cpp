@@ -0,0 +1,206 @@
+// Checks the block signals: trains of different speeds on a loop and on an open track must never run into a
+// block another train holds, a train refused on held blocks must give back every block it took, and times the
+// signals against the fleet update on a long loop, exits with 1 on the first failure.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/test_block_signals.cpp -o test_block_signals
+// Usage: test_block_signals [ticks]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+#include "solution/block_signals.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Global settings
+//-----------------------------------------------------------------------------
+
+#define SETTINGS_TRAIN_SPEED        1.2f
+#define SETTINGS_TRAIN_ACCELERATION 0.4f
+#define SETTINGS_TRAIN_BRAKING      0.8f
+#define SETTINGS_CARS_COUNT         4
+#define SETTINGS_CARS_COUPLING      1.4f
+#define SETTINGS_TRAIN_LENGTH       (SETTINGS_CARS_COUPLING * (SETTINGS_CARS_COUNT - 1))
+#define SETTINGS_BLOCK_LENGTH       1.5f
+#define SETTINGS_FIXED_TIMESTEP     (1.0f / 60.0f)
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+// every car of the n-th train of the fleet sits in a block that train holds, a head stopped at the end of its
+// authority lies on the start of the next block and counts as inside the one it ends
+static bool isInside(const BlockSignals & signals, const TrainFleet & fleet, const size_t n) {
+	for (size_t car = n * SETTINGS_CARS_COUNT; car < (n + 1) * SETTINGS_CARS_COUNT; car++) {
+		const float distance = fleet.getDistances()[car] - fleet.getOffsets()[car];
+		if (signals.getOwner(signals.getBlock(distance)) != n && signals.getOwner(signals.getBlock(distance - 1e-3f)) != n) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// the id a refused train would have taken blocks under is the train count getOwner reports for free blocks,
+// so free blocks are told apart by isOccupied
+static std::vector<size_t> getOwners(const BlockSignals & signals) {
+	std::vector<size_t> result;
+	for (size_t block = 0; block < signals.getBlockCount(); block++) {
+		result.push_back(signals.isOccupied(block) ? signals.getOwner(block) : numeric_limits<size_t>::max());
+	}
+	return result;
+}
+
+// adds a train of SETTINGS_CARS_COUNT cars with its head at the given arc length, false if the signals refused it
+static bool addTrain(BlockSignals & signals, TrainFleet & fleet, const uint32_t track, const float head,
+                     const float speed) {
+	const size_t first = fleet.size();
+	for (size_t car = 0; car < SETTINGS_CARS_COUNT; car++) {
+		fleet.addCar(track, head, speed, SETTINGS_CARS_COUPLING * static_cast<float>(car));
+	}
+	return signals.addTrain(fleet, first, SETTINGS_CARS_COUNT, SETTINGS_TRAIN_LENGTH);
+}
+
+int main(int argc, char ** argv) {
+	const size_t ticks = argc > 1 ? strtoul(argv[1], nullptr, 10) : 6000;
+
+	const std::vector<vec3> controlPoints = {
+		{ 0.0f, -0.375f, 7.0f },
+		{ -6.0f, -0.375f, 5.0f },
+		{ -8.0f, -0.375f, 1.0f },
+		{ -4.0f, -0.375f, -6.0f },
+		{ 0.0f, -0.375f, -7.0f },
+		{ 1.0f, -0.375f, -4.0f },
+		{ 4.0f, -0.375f, -3.0f },
+		{ 8.0f, -0.375f, 7.0f }
+	};
+
+	//-----------------------------------------------------------------------------
+	// A refused train gives back every block it took, also where its blocks wrap around the end of a loop
+	//-----------------------------------------------------------------------------
+
+	{
+		const Spline spline(controlPoints, 0.01f, true);
+		const SplineFrames frames(spline);
+		TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+		const uint32_t track = fleet.addTrack(frames);
+		BlockSignals signals(spline, SETTINGS_BLOCK_LENGTH);
+		if (!addTrain(signals, fleet, track, 20.0f, SETTINGS_TRAIN_SPEED) ||
+		    !addTrain(signals, fleet, track, 1.0f, SETTINGS_TRAIN_SPEED)) {
+			printf("FAIL: a train on free blocks was refused\n");
+			return 1;
+		}
+		const std::vector<size_t> owners = getOwners(signals);
+
+		// heads in the middle of a held train, tails on free blocks behind one, and the tail behind the end of
+		// the loop with the head on blocks the train at 1.0 holds
+		for (const float head : { 19.0f, 18.0f + SETTINGS_TRAIN_LENGTH, 22.0f, 2.0f, spline.distance() + 0.5f }) {
+			if (addTrain(signals, fleet, track, head, SETTINGS_TRAIN_SPEED) || signals.getTrainCount() != 2 ||
+			    getOwners(signals) != owners) {
+				printf("FAIL: a train with its head at %g was not refused cleanly\n", head);
+				return 1;
+			}
+		}
+		printf("trains refused on held blocks took none of them\n");
+	}
+
+	//-----------------------------------------------------------------------------
+	// Fast trains behind slow ones, every car is checked against the held blocks after every tick
+	//-----------------------------------------------------------------------------
+
+	for (const bool isLoop : { true, false }) {
+		const Spline spline(controlPoints, 0.01f, isLoop);
+		const SplineFrames frames(spline);
+		TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+		const uint32_t track = fleet.addTrack(frames, !isLoop);
+		BlockSignals signals(spline, SETTINGS_BLOCK_LENGTH);
+
+		// spread evenly with a gap of two blocks, the speeds alternate between slow and fast
+		const size_t trains = static_cast<size_t>(spline.distance() / (SETTINGS_TRAIN_LENGTH + 3.0f * SETTINGS_BLOCK_LENGTH));
+		for (size_t n = 0; n < trains; n++) {
+			const float head = SETTINGS_TRAIN_LENGTH + spline.distance() * static_cast<float>(n) / static_cast<float>(trains);
+			if (!addTrain(signals, fleet, track, head, SETTINGS_TRAIN_SPEED * (n % 2 ? 2.0f : 0.5f))) {
+				printf("FAIL: train %zu was refused\n", n);
+				return 1;
+			}
+		}
+
+		// arc length every train ran, the fleet wraps the distances on a loop
+		std::vector<float> runs(trains, .0f);
+		std::vector<float> velocities(trains, .0f);
+		size_t held = 0;
+		for (size_t tick = 0; tick < ticks; tick++) {
+			signals.update(fleet);
+			fleet.update(SETTINGS_FIXED_TIMESTEP);
+			for (size_t n = 0; n < trains; n++) {
+				if (!isInside(signals, fleet, n)) {
+					printf("FAIL: %s track, train %zu left its blocks at tick %zu\n", isLoop ? "loop" : "open", n, tick);
+					return 1;
+				}
+				// a train braking for the end of its blocks
+				const float velocity = fleet.getVelocities()[n * SETTINGS_CARS_COUNT];
+				runs[n] += velocity * SETTINGS_FIXED_TIMESTEP;
+				held += velocity < velocities[n] ? 1 : 0;
+				velocities[n] = velocity;
+			}
+		}
+
+		const float slowest = *std::min_element(runs.begin(), runs.end());
+		const float fastest = *std::max_element(runs.begin(), runs.end());
+		printf("%s track: %zu trains, %zu ticks, every car inside its blocks, runs %.1f to %.1f, %zu train ticks braking\n",
+		       isLoop ? "loop" : "open", trains, ticks, slowest, fastest, held);
+		if (held == 0 || (isLoop && slowest <= .0f)) {
+			printf("FAIL: the signals never held a train or a train never moved\n");
+			return 1;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Signals against the fleet update on a long loop with a thousand trains
+	//-----------------------------------------------------------------------------
+
+	{
+		std::vector<vec3> circle;
+		for (int i = 0; i < 64; i++) {
+			const float angle = 6.2831853f * static_cast<float>(i) / 64.0f;
+			circle.emplace_back(1600.0f * std::cos(angle), 0.0f, 1600.0f * std::sin(angle));
+		}
+		const Spline spline(circle, 0.01f, true);
+		const SplineFrames frames(spline);
+		TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+		const uint32_t track = fleet.addTrack(frames);
+		BlockSignals signals(spline, SETTINGS_BLOCK_LENGTH);
+		const size_t trains = 1000;
+		for (size_t n = 0; n < trains; n++) {
+			const float head = spline.distance() * static_cast<float>(n) / static_cast<float>(trains);
+			if (!addTrain(signals, fleet, track, head, SETTINGS_TRAIN_SPEED * (n % 2 ? 2.0f : 0.5f))) {
+				printf("FAIL: train %zu was refused\n", n);
+				return 1;
+			}
+		}
+
+		double signalSeconds = .0;
+		double fleetSeconds = .0;
+		for (size_t tick = 0; tick < ticks; tick++) {
+			auto start = chrono::steady_clock::now();
+			signals.update(fleet);
+			signalSeconds += getSeconds(start);
+			start = chrono::steady_clock::now();
+			fleet.update(SETTINGS_FIXED_TIMESTEP);
+			fleetSeconds += getSeconds(start);
+		}
+		const double carTicks = static_cast<double>(fleet.size()) * static_cast<double>(ticks);
+		printf("%zu trains of %d cars: signals %.1f ns and fleet update %.1f ns per car and tick\n", trains,
+		       SETTINGS_CARS_COUNT, signalSeconds * 1e9 / carTicks, fleetSeconds * 1e9 / carTicks);
+	}
+
+	printf("OK\n");
+	return 0;
+}
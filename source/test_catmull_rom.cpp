@@ -0,0 +1,122 @@
+// Checks the batched Catmull-Rom kernel against glm::catmullRom from glm/gtx/spline.hpp, both on random
+// segments and on the points of whole tessellated splines, exits with 1 on the first disagreement.
+// The path is chosen at compile time, build and run it once per path, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource -mavx source/test_catmull_rom.cpp -o test_catmull_rom_avx
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/test_catmull_rom.cpp -o test_catmull_rom_sse
+//   g++ -std=c++14 -O2 -Iinclude -Isource -DCATMULL_ROM_SCALAR source/test_catmull_rom.cpp -o test_catmull_rom_scalar
+// Usage: test_catmull_rom [segments]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/spline.hpp"
+
+#include "solution/spline.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+
+#if defined(CATMULL_ROM_AVX)
+static const char * Path = "AVX";
+#elif defined(CATMULL_ROM_SSE)
+static const char * Path = "SSE";
+#else
+static const char * Path = "scalar";
+#endif
+
+// both are cubics in t, they differ only by rounding, which grows with the size of the coordinates
+static float getTolerance(const vec3 & p1, const vec3 & p2, const vec3 & p3, const vec3 & p4) {
+	const vec3 size = max(max(abs(p1), abs(p2)), max(abs(p3), abs(p4)));
+	return 1e-5f * (1.0f + std::max(size.x, std::max(size.y, size.z)));
+}
+
+static bool check(const vec3 & expected, const vec3 & actual, const float tolerance, float & worst) {
+	const float error = length(expected - actual);
+	worst = std::max(worst, error);
+	return error <= tolerance;
+}
+
+int main(int argc, char ** argv) {
+	const size_t segments = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+	mt19937 random(4);
+	uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+	const auto getPoint = [&random, &coordinate]() {
+		return vec3(coordinate(random), coordinate(random) * 0.1f, coordinate(random));
+	};
+
+	//-----------------------------------------------------------------------------
+	// Random segments, every batch width and every tail length
+	//-----------------------------------------------------------------------------
+
+	float worst = 0.0f;
+	size_t samples = 0;
+	size_t identical = 0;
+	for (size_t s = 0; s < segments; s++) {
+		const vec3 p1 = getPoint(), p2 = getPoint(), p3 = getPoint(), p4 = getPoint();
+		const CatmullRom curve(p1, p2, p3, p4);
+		const size_t n = 1 + s % 37;
+		const float step = 1.0f / static_cast<float>(n);
+		std::vector<float> x(n), y(n), z(n);
+		curve.evaluate(n, step, x.data(), y.data(), z.data());
+
+		const float tolerance = getTolerance(p1, p2, p3, p4);
+		for (size_t i = 0; i < n; i++) {
+			const float t = static_cast<float>(i) * step;
+			const vec3 actual(x[i], y[i], z[i]);
+			if (!check(catmullRom(p1, p2, p3, p4, t), actual, tolerance, worst)) {
+				printf("FAIL %s: segment %zu, t = %g, off by %g\n", Path, s, t, length(catmullRom(p1, p2, p3, p4, t) - actual));
+				return 1;
+			}
+			identical += curve.get(t) == actual ? 1 : 0;
+			samples++;
+		}
+	}
+	printf("%s kernel: %zu samples of %zu segments, worst error %g, %zu identical to the scalar evaluation\n", Path,
+	       samples, segments, worst, identical);
+
+	//-----------------------------------------------------------------------------
+	// Whole splines, the control points of the ends are clamped on open tracks and wrapped on loops
+	//-----------------------------------------------------------------------------
+
+	for (const bool isLoop : { false, true }) {
+		std::vector<vec3> controlPoints;
+		for (int i = 0; i < 50; i++) {
+			controlPoints.push_back(getPoint());
+		}
+		const float eps = 0.01f;
+		const Spline spline(controlPoints, eps, isLoop);
+
+		const auto count = static_cast<ptrdiff_t>(controlPoints.size());
+		const auto getControl = [&controlPoints, count, isLoop](const ptrdiff_t idx) {
+			return controlPoints[isLoop ? (idx + count) % count : clamp<ptrdiff_t>(idx, 0, count - 1)];
+		};
+		const size_t lines = static_cast<size_t>(std::round(1.0f / eps));
+		const size_t segmentCount = isLoop ? controlPoints.size() : controlPoints.size() - 1;
+		worst = 0.0f;
+		for (size_t segment = 0; segment < segmentCount; segment++) {
+			const auto idx = static_cast<ptrdiff_t>(segment);
+			const vec3 p1 = getControl(idx - 1), p2 = getControl(idx), p3 = getControl(idx + 1), p4 = getControl(idx + 2);
+			for (size_t i = 0; i < lines; i++) {
+				const size_t k = segment * lines + i;
+				const float t = static_cast<float>(i) / static_cast<float>(lines);
+				if (k >= spline.getPoints().size() ||
+				    !check(catmullRom(p1, p2, p3, p4, t), spline.getPoints().get(k), getTolerance(p1, p2, p3, p4), worst)) {
+					printf("FAIL %s: %s spline, segment %zu, line %zu\n", Path, isLoop ? "loop" : "open", segment, i);
+					return 1;
+				}
+			}
+		}
+		printf("%s %s spline: %zu points, worst error %g\n", Path, isLoop ? "loop" : "open", spline.getPoints().size(),
+		       worst);
+	}
+
+	printf("OK\n");
+	return 0;
+}
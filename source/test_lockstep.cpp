@@ -0,0 +1,131 @@
+// Checks the lockstep hash chain: a serial run and runs split across the job system must produce the same hash
+// after every tick, in floating and in fixed point, and findDivergence must return the first tick of a run
+// nudged part of the way through, exits with 1 on the first failure.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -pthread -Iinclude -Isource source/test_lockstep.cpp -o test_lockstep
+// Usage: test_lockstep [trains] [ticks]
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "solution/lockstep.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Global settings
+//-----------------------------------------------------------------------------
+
+#define SETTINGS_TRAIN_SPEED        1.2f
+#define SETTINGS_TRAIN_ACCELERATION 0.4f
+#define SETTINGS_TRAIN_BRAKING      0.8f
+#define SETTINGS_CARS_COUNT         4
+#define SETTINGS_CARS_COUPLING      1.4f
+#define SETTINGS_FIXED_TIMESTEP     (1.0f / 60.0f)
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char ** argv) {
+	// enough cars for a few chunks of the grain TrainFleet::update splits them in
+	const size_t trains = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000;
+	const size_t ticks = argc > 2 ? strtoul(argv[2], nullptr, 10) : 600;
+
+	const std::vector<vec3> controlPoints = {
+		{ 0.0f, -0.375f, 7.0f },
+		{ -6.0f, -0.375f, 5.0f },
+		{ -8.0f, -0.375f, 1.0f },
+		{ -4.0f, -0.375f, -6.0f },
+		{ 0.0f, -0.375f, -7.0f },
+		{ 1.0f, -0.375f, -4.0f },
+		{ 4.0f, -0.375f, -3.0f },
+		{ 8.0f, -0.375f, 7.0f }
+	};
+	const Spline loop(controlPoints, 0.01f, true);
+	const Spline open(controlPoints, 0.01f, false);
+	const SplineFrames loopFrames(loop);
+	const SplineFrames openFrames(open);
+
+	// half of the trains run on the loop, the others brake to a stop at the end of the open track, with speeds
+	// that vary so that some of them are still accelerating
+	const auto populate = [&](TrainFleet & fleet, const bool isFixedPoint) {
+		const uint32_t loopTrack = fleet.addTrack(loopFrames);
+		const uint32_t openTrack = fleet.addTrack(openFrames);
+		for (size_t i = 0; i < trains; i++) {
+			const Spline & spline = i % 2 ? loop : open;
+			const float head = spline.distance() * static_cast<float>(i) / static_cast<float>(trains);
+			const float speed = SETTINGS_TRAIN_SPEED * (0.5f + static_cast<float>(i % 7) / 6.0f);
+			for (size_t car = 0; car < SETTINGS_CARS_COUNT; car++) {
+				fleet.addCar(i % 2 ? loopTrack : openTrack, head, speed, SETTINGS_CARS_COUPLING * static_cast<float>(car));
+			}
+		}
+		fleet.setFixedPoint(isFixedPoint);
+	};
+
+	for (const bool isFixedPoint : { false, true }) {
+		const char * mode = isFixedPoint ? "fixed point" : "floating point";
+
+		//-----------------------------------------------------------------------------
+		// Serial and job system runs, tick by tick
+		//-----------------------------------------------------------------------------
+
+		TrainFleet serialFleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+		populate(serialFleet, isFixedPoint);
+		Lockstep serial(serialFleet, SETTINGS_FIXED_TIMESTEP);
+		serial.run(ticks);
+
+		for (const size_t threads : { 1, 2, 4, 8 }) {
+			TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+			populate(fleet, isFixedPoint);
+			JobSystem jobs(threads);
+			Lockstep lockstep(fleet, SETTINGS_FIXED_TIMESTEP);
+			lockstep.run(ticks, &jobs);
+			if (lockstep.getHashes() != serial.getHashes() ||
+			    Lockstep::findDivergence(lockstep.getHashes(), serial.getHashes()) != ticks) {
+				printf("FAIL: %s, %zu threads diverge from serial at tick %zu\n", mode, threads,
+				       Lockstep::findDivergence(lockstep.getHashes(), serial.getHashes()));
+				return 1;
+			}
+		}
+		printf("%s: %zu cars, %zu ticks, job system runs at 1 to 8 threads hash the same as serial\n", mode,
+		       serialFleet.size(), ticks);
+
+		//-----------------------------------------------------------------------------
+		// One car nudged by a millimetre after a number of ticks, the chain must part from that tick on
+		//-----------------------------------------------------------------------------
+
+		for (const size_t at : { size_t(0), size_t(1), ticks / 3, ticks - 1 }) {
+			TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+			populate(fleet, isFixedPoint);
+			JobSystem jobs(2);
+			Lockstep lockstep(fleet, SETTINGS_FIXED_TIMESTEP);
+			lockstep.run(at, &jobs);
+			// a car on the loop, it never stops so the nudge cannot be absorbed at the end of the track
+			const size_t car = SETTINGS_CARS_COUNT + 1;
+			fleet.setTrack(car, fleet.getTrackIds()[car], fleet.getDistances()[car] + 0.001f);
+			lockstep.run(ticks - at, &jobs);
+
+			size_t expected = 0;
+			while (expected < ticks && lockstep.getHashes()[expected] == serial.getHashes()[expected]) {
+				expected++;
+			}
+			const size_t divergence = Lockstep::findDivergence(lockstep.getHashes(), serial.getHashes());
+			if (expected != at || divergence != at) {
+				printf("FAIL: %s, nudged after %zu ticks, found tick %zu, a linear scan finds %zu\n", mode, at,
+				       divergence, expected);
+				return 1;
+			}
+		}
+		printf("%s: findDivergence returns the tick of the nudge\n", mode);
+
+		// a run that stopped early is a prefix of the full one
+		const std::vector<uint64_t> prefix(serial.getHashes().begin(), serial.getHashes().begin() + ticks / 2);
+		if (Lockstep::findDivergence(prefix, serial.getHashes()) != ticks / 2) {
+			printf("FAIL: %s, a prefix diverges at tick %zu\n", mode, Lockstep::findDivergence(prefix, serial.getHashes()));
+			return 1;
+		}
+	}
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,158 @@
+// Checks SplineGrid::nearest and SplineGrid::radius against a brute-force search over every line of the track,
+// for random points around it, points far outside the grid and points along the closing segment of a loop,
+// before and after a control point moves, exits with 1 on the first disagreement.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/test_spline_grid.cpp -o test_spline_grid
+// Usage: test_spline_grid [queries]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+
+#include "solution/spline_grid.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+
+// closest distance from the point to every segment, infinity for segments without lines
+static std::vector<float> getRanges(const Spline & spline, const vec3 & point) {
+	std::vector<float> result(spline.size(), numeric_limits<float>::max());
+	const SplinePoints & points = spline.getPoints();
+	const std::vector<size_t> & offsets = spline.getOffsets();
+	for (size_t segment = 0; segment < spline.size(); segment++) {
+		for (size_t k = offsets[segment]; k < offsets[segment + 1]; k++) {
+			const vec3 p1 = points.get(k);
+			const vec3 line = points.get(k + 1) - p1;
+			const float length = dot(line, line);
+			const float dt = length > .0f ? clamp(dot(point - p1, line) / length, .0f, 1.0f) : .0f;
+			result[segment] = std::min(result[segment], distance(point, p1 + dt * line));
+		}
+	}
+	return result;
+}
+
+static bool isClose(const float a, const float b) {
+	return std::abs(a - b) <= 1e-4f * (1.0f + std::abs(b));
+}
+
+// nearest with and without a range limit and radius for a few radii, all against the brute force
+static bool check(const SplineGrid & grid, const Spline & spline, const vec3 & point, const char * kind) {
+	const std::vector<float> ranges = getRanges(spline, point);
+	const float closest = *std::min_element(ranges.begin(), ranges.end());
+
+	SplineHit hit;
+	if (!grid.nearest(point, hit) || !isClose(hit.range, closest) || !isClose(distance(point, hit.point), hit.range) ||
+	    !isClose(distance(spline.getAtDistance(hit.distance), hit.point), .0f)) {
+		printf("FAIL %s: nearest at (%g, %g, %g) found %g, expected %g\n", kind, point.x, point.y, point.z,
+		       hit.range, closest);
+		return false;
+	}
+	for (const float limit : { 0.5f * closest, 1.5f * closest + 0.1f }) {
+		const bool isFound = grid.nearest(point, hit, limit);
+		if (isFound != (closest <= limit) || (isFound && !isClose(hit.range, closest))) {
+			printf("FAIL %s: nearest at (%g, %g, %g) within %g\n", kind, point.x, point.y, point.z, limit);
+			return false;
+		}
+	}
+
+	for (const float radius : { 0.5f, 2.0f, 6.0f }) {
+		const std::vector<SplineHit> hits = grid.radius(point, radius);
+		size_t expected = 0;
+		for (size_t segment = 0; segment < ranges.size(); segment++) {
+			// a segment right at the radius may fall either way by rounding
+			if (std::abs(ranges[segment] - radius) < 1e-4f) {
+				continue;
+			}
+			const bool isInside = ranges[segment] < radius;
+			expected += isInside ? 1 : 0;
+			const auto it = std::find_if(hits.begin(), hits.end(), [segment](const SplineHit & candidate) {
+				return candidate.segment == segment;
+			});
+			if ((it != hits.end()) != isInside || (isInside && !isClose(it->range, ranges[segment]))) {
+				printf("FAIL %s: radius %g at (%g, %g, %g), segment %zu at %g\n", kind, radius, point.x, point.y,
+				       point.z, segment, ranges[segment]);
+				return false;
+			}
+		}
+		if (hits.size() < expected) {
+			printf("FAIL %s: radius %g at (%g, %g, %g) found %zu segments, expected %zu\n", kind, radius, point.x,
+			       point.y, point.z, hits.size(), expected);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	const size_t queries = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000;
+	mt19937 random(7);
+	uniform_real_distribution<float> unit(.0f, 1.0f);
+
+	const std::vector<vec3> controlPoints = {
+		{ 0.0f, -0.375f, 7.0f },
+		{ -6.0f, -0.375f, 5.0f },
+		{ -8.0f, 0.5f, 1.0f },
+		{ -4.0f, -0.375f, -6.0f },
+		{ 0.0f, -0.375f, -7.0f },
+		{ 1.0f, 1.0f, -4.0f },
+		{ 4.0f, -0.375f, -3.0f },
+		{ 8.0f, -0.375f, 7.0f }
+	};
+
+	for (const bool isLoop : { false, true }) {
+		for (const float cellSize : { 0.5f, 1.0f, 3.0f }) {
+			Spline spline(controlPoints, 0.01f, isLoop);
+			SplineGrid grid(spline, cellSize);
+
+			for (int pass = 0; pass < 2; pass++) {
+				size_t checked = 0;
+				// random points in and around the bounds of the track
+				for (size_t i = 0; i < queries; i++) {
+					const vec3 point(mix(-12.0f, 12.0f, unit(random)), mix(-3.0f, 3.0f, unit(random)),
+					                 mix(-11.0f, 11.0f, unit(random)));
+					if (!check(grid, spline, point, "inside")) {
+						return 1;
+					}
+					checked++;
+				}
+				// far outside of every occupied cell
+				for (size_t i = 0; i < queries / 20; i++) {
+					const float angle = 6.2831853f * unit(random);
+					const vec3 point = vec3(std::cos(angle), unit(random) - 0.5f, std::sin(angle)) * mix(30.0f, 300.0f, unit(random));
+					if (!check(grid, spline, point, "outside")) {
+						return 1;
+					}
+					checked++;
+				}
+				// along the segment that closes a loop, or the gap between the ends of an open track
+				const vec3 & from = controlPoints.back();
+				const vec3 & to = controlPoints.front();
+				for (size_t i = 0; i < queries / 10; i++) {
+					const vec3 jitter = (vec3(unit(random), unit(random), unit(random)) - 0.5f) * 2.0f;
+					if (!check(grid, spline, mix(from, to, unit(random)) + jitter, "closing")) {
+						return 1;
+					}
+					checked++;
+				}
+				printf("%s track, cell size %g, %s: %zu queries agree with the brute force\n", isLoop ? "loop" : "open",
+				       cellSize, pass == 0 ? "as built" : "after a control point moved", checked);
+
+				// the second pass runs on the grid updated segment by segment
+				const std::vector<SplineRange> ranges = spline.updateControlPoint(2, { -9.0f, 1.5f, 2.5f });
+				for (const SplineRange & range : ranges) {
+					for (size_t segment = range.firstSegment; segment < range.lastSegment; segment++) {
+						grid.update(segment);
+					}
+				}
+			}
+		}
+	}
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,132 @@
+// Checks Spline::updateControlPoint: after every move of a control point the spline must match one built from
+// scratch from the edited control points, for open tracks and loops tessellated uniformly and adaptively, and
+// the segments it did not report must keep their points, exits with 1 on the first difference.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/test_spline_update.cpp -o test_spline_update
+// Usage: test_spline_update [moves]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "solution/spline.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+
+static Spline make(const std::vector<vec3> & controlPoints, const bool isLoop, const bool isAdaptive) {
+	Spline result;
+	return isAdaptive ? result.constructAdaptive(controlPoints, 0.01f, isLoop) : result.construct(controlPoints, 0.01f, isLoop);
+}
+
+// points of one segment, up to and including the first point of the next one
+static std::vector<vec3> getSegmentPoints(const Spline & spline, const size_t segment) {
+	std::vector<vec3> result;
+	for (size_t k = spline.getOffsets()[segment]; k <= spline.getOffsets()[segment + 1]; k++) {
+		result.push_back(spline.getPoints().get(k));
+	}
+	return result;
+}
+
+// points, offsets, arc lengths and the curve parameter of every point against a fresh spline, worst errors in
+// position and in arc length are accumulated
+static bool compare(const Spline & spline, const Spline & fresh, float & worstPoint, float & worstDistance) {
+	if (spline.getControlPoints() != fresh.getControlPoints() || spline.getOffsets() != fresh.getOffsets() ||
+	    spline.getPoints().size() != fresh.getPoints().size() ||
+	    spline.getDistances().size() != fresh.getDistances().size()) {
+		printf("FAIL: %zu points in %zu segments, a fresh spline has %zu in %zu\n", spline.getPoints().size(),
+		       spline.size(), fresh.getPoints().size(), fresh.size());
+		return false;
+	}
+	for (size_t k = 0; k < spline.getPoints().size(); k++) {
+		const float point = distance(spline.getPoints().get(k), fresh.getPoints().get(k));
+		// the curve evaluated at the parameter of the point lands on it
+		const float sample = distance(spline.samplePoint(k).position, fresh.getPoints().get(k));
+		const float error = std::abs(spline.getDistances()[k] - fresh.getDistances()[k]);
+		worstPoint = std::max(worstPoint, std::max(point, sample));
+		worstDistance = std::max(worstDistance, error);
+		if (point > 1e-6f || sample > 1e-5f || error > 1e-4f * (1.0f + fresh.getDistances()[k])) {
+			printf("FAIL: point %zu is %g off, its sample %g and its arc length %g\n", k, point, sample, error);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	const size_t moves = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200;
+	mt19937 random(3);
+	uniform_real_distribution<float> offset(-3.0f, 3.0f);
+
+	const std::vector<vec3> controlPoints = {
+		{ 0.0f, -0.375f, 7.0f },
+		{ -6.0f, -0.375f, 5.0f },
+		{ -8.0f, 0.5f, 1.0f },
+		{ -4.0f, -0.375f, -6.0f },
+		{ 0.0f, -0.375f, -7.0f },
+		{ 1.0f, 1.0f, -4.0f },
+		{ 4.0f, -0.375f, -3.0f },
+		{ 8.0f, -0.375f, 7.0f }
+	};
+
+	for (const bool isLoop : { false, true }) {
+		for (const bool isAdaptive : { false, true }) {
+			std::vector<vec3> edited = controlPoints;
+			Spline spline = make(edited, isLoop, isAdaptive);
+			uniform_int_distribution<size_t> pick(0, edited.size() - 1);
+			float worstPoint = .0f;
+			float worstDistance = .0f;
+			size_t resized = 0;
+
+			// the ends first, they shape the first and the last segment and for a loop the closing one
+			for (size_t move = 0; move < moves; move++) {
+				const size_t idx = move == 0 ? 0 : move == 1 ? edited.size() - 1 : pick(random);
+				edited[idx] = controlPoints[idx] + vec3(offset(random), 0.2f * offset(random), offset(random));
+
+				std::vector<std::vector<vec3>> before;
+				for (size_t segment = 0; segment < spline.size(); segment++) {
+					before.push_back(getSegmentPoints(spline, segment));
+				}
+				const size_t points = spline.getPoints().size();
+				const std::vector<SplineRange> ranges = spline.updateControlPoint(idx, edited[idx]);
+				resized += spline.getPoints().size() != points ? 1 : 0;
+
+				if (!compare(spline, make(edited, isLoop, isAdaptive), worstPoint, worstDistance)) {
+					printf("FAIL: %s %s spline after moving control point %zu\n", isAdaptive ? "adaptive" : "uniform",
+					       isLoop ? "loop" : "open", idx);
+					return 1;
+				}
+				for (size_t segment = 0; segment < spline.size(); segment++) {
+					const bool isReported = std::any_of(ranges.begin(), ranges.end(), [segment](const SplineRange & range) {
+						return segment >= range.firstSegment && segment < range.lastSegment;
+					});
+					// the last point of a segment is the first one of the next, which may have moved
+					std::vector<vec3> after = getSegmentPoints(spline, segment);
+					const size_t next = isLoop ? (segment + 1) % spline.size() : segment + 1;
+					const bool isNextReported = std::any_of(ranges.begin(), ranges.end(), [next](const SplineRange & range) {
+						return next >= range.firstSegment && next < range.lastSegment;
+					});
+					if (isNextReported) {
+						after.pop_back();
+						before[segment].pop_back();
+					}
+					if (!isReported && after != before[segment]) {
+						printf("FAIL: segment %zu changed after moving control point %zu but was not reported\n", segment,
+						       idx);
+						return 1;
+					}
+				}
+			}
+			printf("%s %s spline: %zu moves, %zu changed the point count, worst point error %g, arc length %g\n",
+			       isAdaptive ? "adaptive" : "uniform ", isLoop ? "loop" : "open", moves, resized, worstPoint,
+			       worstDistance);
+		}
+	}
+
+	printf("OK\n");
+	return 0;
+}
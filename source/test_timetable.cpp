@@ -0,0 +1,179 @@
+// Checks the timetable: the analytic motion profile against its inverse, that a train is refused on blocks
+// another one holds and that trains calling at stations around the demo loop for a whole day never run into
+// each other, exits with 1 on the first failure.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/test_timetable.cpp -o test_timetable
+// Usage: test_timetable [trains]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "solution/timetable.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Global settings
+//-----------------------------------------------------------------------------
+
+#define SETTINGS_TRAIN_SPEED        1.2f
+#define SETTINGS_TRAIN_ACCELERATION 0.4f
+#define SETTINGS_TRAIN_BRAKING      0.8f
+#define SETTINGS_TRAIN_LENGTH       4.2f
+#define SETTINGS_BLOCK_LENGTH       1.5f
+#define SETTINGS_STATIONS           8
+#define SETTINGS_DWELL              20.0
+#define SETTINGS_DAY                (24.0 * 3600.0)
+
+//-----------------------------------------------------------------------------
+
+static double getSeconds(const chrono::steady_clock::time_point & from) {
+	return chrono::duration<double>(chrono::steady_clock::now() - from).count();
+}
+
+// the profile reaches its distance, never runs backwards and getTime undoes getDistance
+static bool checkProfile(const MotionProfile & profile) {
+	const double duration = profile.getDuration();
+	if (std::abs(profile.getDistance(duration) - profile.distance) > 1e-9 * (1.0 + profile.distance)) {
+		printf("FAIL: %g units end at %g\n", profile.distance, profile.getDistance(duration));
+		return false;
+	}
+	double previous = .0;
+	double worst = .0;
+	const int samples = 100000;
+	for (int i = 0; i <= samples; i++) {
+		const double t = duration * static_cast<double>(i) / samples;
+		const double s = profile.getDistance(t);
+		if (s < previous) {
+			printf("FAIL: %g units run backwards at %g s\n", profile.distance, t);
+			return false;
+		}
+		previous = s;
+		// the braking ramp is read backwards from the end, where a rounding of the distance left is a large
+		// error in time, so the time is checked against what that rounding allows
+		const double left = profile.distance - s;
+		const double rounding = left > .0 ? 1e-15 * (1.0 + profile.distance) / std::sqrt(2.0 * left * profile.braking)
+		                                  : 1e-7;
+		const double allowed = 1e-9 * (1.0 + duration) + rounding;
+		const double error = std::abs(profile.getTime(s) - t);
+		worst = std::max(worst, error);
+		if (error > allowed) {
+			printf("FAIL: %g units, getTime(getDistance(%.17g)) = %.17g\n", profile.distance, t, profile.getTime(s));
+			return false;
+		}
+	}
+	printf("profile %8g units: %9.3f s, peak %.3f, worst time error %.3g s\n", profile.distance, duration,
+	       profile.peak, worst);
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	// at least two so that every train has one ahead of it
+	const int trains = std::max(argc > 1 ? atoi(argv[1]) : 6, 2);
+
+	//-----------------------------------------------------------------------------
+	// Analytic profile, short runs that never reach the speed and long ones that cruise
+	//-----------------------------------------------------------------------------
+
+	for (const double distance : { 0.01, 0.5, 2.7, 3.0, 50.0, 1000.0, 86400.0 }) {
+		if (!checkProfile(MotionProfile::make(distance, SETTINGS_TRAIN_SPEED, SETTINGS_TRAIN_ACCELERATION,
+		                                      SETTINGS_TRAIN_BRAKING))) {
+			return 1;
+		}
+	}
+
+	const std::vector<vec3> controlPoints = {
+		{ 0.0f, -0.375f, 7.0f },
+		{ -6.0f, -0.375f, 5.0f },
+		{ -8.0f, -0.375f, 1.0f },
+		{ -4.0f, -0.375f, -6.0f },
+		{ 0.0f, -0.375f, -7.0f },
+		{ 1.0f, -0.375f, -4.0f },
+		{ 4.0f, -0.375f, -3.0f },
+		{ 8.0f, -0.375f, 7.0f }
+	};
+	const Spline spline(controlPoints, 0.01f, true);
+	const double total = spline.distance();
+
+	//-----------------------------------------------------------------------------
+	// A train is refused on blocks another one holds and takes none of them
+	//-----------------------------------------------------------------------------
+
+	{
+		Timetable timetable(spline, SETTINGS_BLOCK_LENGTH, SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+		const double from = 10.0;
+		timetable.addTrain(.0, SETTINGS_TRAIN_SPEED, SETTINGS_TRAIN_LENGTH, { { from, .0 }, { from + 10.0, .0 } });
+		std::vector<size_t> owners;
+		for (size_t block = 0; block < timetable.getBlockCount(); block++) {
+			owners.push_back(timetable.getOwner(block));
+		}
+		const uint32_t id = timetable.addTrain(.0, SETTINGS_TRAIN_SPEED, SETTINGS_TRAIN_LENGTH,
+		                                       { { from + 2.0, .0 }, { from + 10.0, .0 } });
+		bool isSame = true;
+		for (size_t block = 0; block < timetable.getBlockCount(); block++) {
+			isSame &= timetable.getOwner(block) == owners[block];
+		}
+		if (id != Timetable::None || timetable.getTrainCount() != 1 || !isSame) {
+			printf("FAIL: a train was added on held blocks\n");
+			return 1;
+		}
+		printf("a train on held blocks is refused\n");
+	}
+
+	//-----------------------------------------------------------------------------
+	// A day of trains spread around the loop calling at every station, the heads are sampled every second
+	//-----------------------------------------------------------------------------
+
+	Timetable timetable(spline, SETTINGS_BLOCK_LENGTH, SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+	const double lap = total / SETTINGS_TRAIN_SPEED + SETTINGS_STATIONS * SETTINGS_DWELL;
+	const int laps = static_cast<int>(SETTINGS_DAY / lap) + 2;
+	for (int n = 0; n < trains; n++) {
+		std::vector<TimetableStop> stops;
+		const double start = total * n / trains;
+		for (int k = 0; k <= laps * SETTINGS_STATIONS; k++) {
+			stops.push_back({ start + total * k / SETTINGS_STATIONS, SETTINGS_DWELL });
+		}
+		if (timetable.addTrain(5.0 * n, SETTINGS_TRAIN_SPEED, SETTINGS_TRAIN_LENGTH, stops) == Timetable::None) {
+			printf("FAIL: train %d overlaps another one\n", n);
+			return 1;
+		}
+	}
+
+	const auto start = chrono::steady_clock::now();
+	double gap = total;
+	for (double t = .0; t <= SETTINGS_DAY; t += 1.0) {
+		timetable.run(t);
+		for (int n = 0; n < trains; n++) {
+			// arc length from the head of a train to the tail of the one ahead of it
+			const auto ahead = static_cast<uint32_t>((n + 1) % trains);
+			double distance = timetable.getDistance(ahead, t) - timetable.getDistance(static_cast<uint32_t>(n), t);
+			distance -= total * std::floor(distance / total);
+			gap = std::min(gap, distance - SETTINGS_TRAIN_LENGTH);
+		}
+		if (gap < .0) {
+			printf("FAIL: trains overlap by %g at %g s\n", -gap, t);
+			return 1;
+		}
+	}
+	const double seconds = getSeconds(start);
+
+	double delay = .0;
+	size_t stops = 0;
+	for (int n = 0; n < trains; n++) {
+		delay += timetable.getDelay(static_cast<uint32_t>(n));
+		stops += timetable.getStop(static_cast<uint32_t>(n));
+	}
+	printf("%d trains for a day: %zu events and %zu calls in %.3f s, %.0f s of delay, closest gap %.3f\n", trains,
+	       timetable.getProcessedCount(), stops, seconds, delay, gap);
+	if (stops == 0 || timetable.getTime() < SETTINGS_DAY) {
+		printf("FAIL: the trains did not run the day\n");
+		return 1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,127 @@
+// Checks that the cars of a train keep their coupling while it runs over a switch into a dead end: the train
+// comes in fast on a feeder and has to brake for the buffer stop with cars still on the feeder, the distance
+// between neighbouring cars must stay at the coupling after every tick, and with the switch set the other way
+// the train must run round the curve past the dead end without braking, exits with 1 on the first failure.
+// Excluded from the windowed project, build it on its own, e.g.:
+//   g++ -std=c++14 -O2 -Iinclude -Isource source/test_track_graph.cpp -o test_track_graph
+// Usage: test_track_graph
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "solution/track_graph.h"
+
+using namespace std;
+using namespace glm;
+
+//-----------------------------------------------------------------------------
+// Global settings
+//-----------------------------------------------------------------------------
+
+#define SETTINGS_TRAIN_ACCELERATION 0.4f
+#define SETTINGS_TRAIN_BRAKING      0.8f
+#define SETTINGS_CARS_COUNT         4
+#define SETTINGS_CARS_COUPLING      1.4f
+#define SETTINGS_FIXED_TIMESTEP     (1.0f / 60.0f)
+#define SETTINGS_FEEDER_LENGTH      30.0f
+
+//-----------------------------------------------------------------------------
+
+int main() {
+	float worst = .0f;
+	for (const bool isFixedPoint : { false, true }) {
+		for (const float deadEnd : { 6.0f, 8.0f, 10.0f }) {
+			for (const float speed : { 3.0f, 4.0f }) {
+				for (const bool isDeadEnd : { true, false }) {
+					// a straight feeder into a switch with a straight dead end and a curve on to the rest of the network
+					TrackGraph graph;
+					const uint32_t from = graph.addNode();
+					const uint32_t junction = graph.addNode();
+					const uint32_t stop = graph.addNode();
+					const uint32_t away = graph.addNode();
+					const float x = SETTINGS_FEEDER_LENGTH;
+					graph.addEdge(from, junction, Spline(std::vector<vec3>{ { 0.0f, 0.0f, 0.0f }, { 0.5f * x, 0.0f, 0.0f },
+					                                                        { x, 0.0f, 0.0f } }, 0.01f, false));
+					graph.addEdge(junction, away, Spline(std::vector<vec3>{ { x, 0.0f, 0.0f }, { x + 6.0f, 0.0f, 4.0f },
+					                                                        { x + 8.0f, 0.0f, 12.0f } }, 0.01f, false));
+					const uint32_t end = graph.addEdge(junction, stop, Spline(std::vector<vec3>{ { x, 0.0f, 0.0f },
+					                                                                             { x + 0.5f * deadEnd, 0.0f, 0.0f },
+					                                                                             { x + deadEnd, 0.0f, 0.0f } },
+					                                                          0.01f, false));
+					graph.addEdge(away, from, Spline(std::vector<vec3>{ { x + 8.0f, 0.0f, 12.0f }, { 0.0f, 0.0f, 12.0f },
+					                                                    { 0.0f, 0.0f, 0.0f } }, 0.01f, false));
+					graph.build();
+					graph.setSwitch(junction, (end == graph.getLeaving(junction, 0)) == isDeadEnd ? 0 : 1);
+
+					TrainFleet fleet(SETTINGS_TRAIN_ACCELERATION, SETTINGS_TRAIN_BRAKING);
+					graph.addTo(fleet);
+					const float head = SETTINGS_CARS_COUPLING * (SETTINGS_CARS_COUNT - 1);
+					for (size_t car = 0; car < SETTINGS_CARS_COUNT; car++) {
+						graph.addCar(fleet, 0, head, speed, SETTINGS_CARS_COUPLING * static_cast<float>(car));
+					}
+					fleet.setFixedPoint(isFixedPoint);
+
+					float closest = SETTINGS_CARS_COUPLING;
+					float furthest = SETTINGS_CARS_COUPLING;
+					float peak = .0f;
+					// through the curve until the tail is past the junction
+					const int ticks = isDeadEnd ? 60 * 60 : static_cast<int>(60.0f * (x + 4.0f) / speed) + 10 * 60;
+					for (int tick = 0; tick < ticks; tick++) {
+						fleet.update(SETTINGS_FIXED_TIMESTEP);
+						graph.update(fleet);
+						fleet.updateTransforms();
+						if (!isDeadEnd && fleet.getVelocities()[0] < peak) {
+							printf("FAIL: at speed %g, the train slowed down for the %g unit dead end it does not take\n", speed,
+							       deadEnd);
+							return 1;
+						}
+						peak = std::max(peak, fleet.getVelocities()[0]);
+						if (!isDeadEnd) {
+							continue;
+						}
+						// the track is straight where the train runs, so the distance is the arc length between cars
+						for (size_t car = 1; car < SETTINGS_CARS_COUNT; car++) {
+							const float gap = distance(vec3(fleet.getTransforms()[car - 1][3]), vec3(fleet.getTransforms()[car][3]));
+							closest = std::min(closest, gap);
+							furthest = std::max(furthest, gap);
+							if (std::abs(gap - SETTINGS_CARS_COUPLING) > 0.01f) {
+								printf("FAIL: %s, %g unit dead end at speed %g, cars %zu and %zu are %g apart at tick %d\n",
+								       isFixedPoint ? "fixed point" : "floating point", deadEnd, speed, car - 1, car, gap, tick);
+								return 1;
+							}
+						}
+					}
+					if (!isDeadEnd) {
+						if (peak != speed || fleet.getTrackIds()[SETTINGS_CARS_COUNT - 1] == graph.getTrack(0)) {
+							printf("FAIL: at speed %g, the train did not run round the curve at its speed\n", speed);
+							return 1;
+						}
+						printf("%s, curve at speed %g: every car past the %g unit dead end without braking\n",
+						       isFixedPoint ? "fixed point   " : "floating point", speed, deadEnd);
+						continue;
+					}
+					worst = std::max(worst, std::max(SETTINGS_CARS_COUPLING - closest, furthest - SETTINGS_CARS_COUPLING));
+
+					// the train stands at the buffer stop with the head on the dead end
+					const float position = fleet.getTransforms()[0][3][0];
+					bool isStopped = fleet.getTrackIds()[0] == graph.getTrack(end) && position <= x + deadEnd + 1e-3f;
+					for (size_t car = 0; car < SETTINGS_CARS_COUNT; car++) {
+						isStopped &= fleet.getVelocities()[car] == .0f;
+					}
+					if (!isStopped) {
+						printf("FAIL: %g unit dead end at speed %g, the train did not stop at its end\n", deadEnd, speed);
+						return 1;
+					}
+					printf("%s, %2g unit dead end at speed %g: peak %.2f, head stopped %.3f before the end, gaps %.4f to %.4f\n",
+					       isFixedPoint ? "fixed point   " : "floating point", deadEnd, speed, peak, x + deadEnd - position,
+					       closest, furthest);
+				}
+			}
+		}
+	}
+	printf("worst deviation from the coupling %g\n", worst);
+
+	printf("OK\n");
+	return 0;
+}